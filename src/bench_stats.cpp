@@ -0,0 +1,47 @@
+#include "bench_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <sys/resource.h>
+
+using namespace std;
+
+TimingSummary summarize_timings(vector<double> times_ms)
+{
+    if (times_ms.empty())
+        throw invalid_argument("No timings to summarize");
+
+    sort(times_ms.begin(), times_ms.end());
+    size_t n = times_ms.size();
+
+    TimingSummary summary;
+    summary.trials = n;
+    summary.min_ms = times_ms.front();
+    summary.median_ms = n % 2 ? times_ms[n / 2] : (times_ms[n / 2 - 1] + times_ms[n / 2]) / 2;
+    summary.p95_ms = times_ms[static_cast<size_t>(ceil(0.95 * n)) - 1];
+
+    // ranks n/2 -+ 1.96 sqrt(n)/2 from the binomial(n, 1/2) approximation, clamped to the sample
+    double half_width = 1.96 * sqrt(static_cast<double>(n)) / 2;
+    double low_rank = floor(n / 2.0 - half_width);
+    double high_rank = ceil(1 + n / 2.0 + half_width);
+    summary.median_low_ms = times_ms[static_cast<size_t>(max(1.0, low_rank)) - 1];
+    summary.median_high_ms = times_ms[static_cast<size_t>(min<double>(n, high_rank)) - 1];
+
+    double sum = 0;
+    for (double t : times_ms) sum += t;
+    summary.mean_ms = sum / n;
+
+    double squares = 0;
+    for (double t : times_ms) squares += (t - summary.mean_ms) * (t - summary.mean_ms);
+    summary.stddev_ms = n > 1 ? sqrt(squares / (n - 1)) : 0.0;
+    return summary;
+}
+
+size_t peak_rss_bytes()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; // kilobytes on Linux
+}
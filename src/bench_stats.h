@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// summary of repeated timings of one configuration, all in milliseconds
+struct TimingSummary
+{
+    size_t trials;
+    double min_ms;
+    double median_ms;
+    double median_low_ms;  // distribution-free ~95% confidence interval of the median
+    double median_high_ms; // (order statistics); min and max below about 6 trials
+    double p95_ms;   // nearest-rank 95th percentile
+    double mean_ms;
+    double stddev_ms; // sample standard deviation, 0 for a single trial
+};
+
+// throws std::invalid_argument when there are no timings
+TimingSummary summarize_timings(std::vector<double> times_ms);
+
+// high-water mark of the process resident set, in bytes
+size_t peak_rss_bytes();
@@ -0,0 +1,259 @@
+#include "benchmark.h"
+#include "parallel_graph.h"
+#include "shortest_paths.h"
+#include "thread_budget.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+using namespace std;
+using json = nlohmann::json;
+
+const vector<BenchAlgorithm>& bench_algorithms()
+{
+    static const vector<BenchAlgorithm> algorithms = {
+        { "floyd", false, false, { "matrix" } },
+        { "floyd_parallel", true, false, { "matrix" } },
+        { "floyd_blocked", true, false, { "matrix" } },
+        { "cc", false, true, { "csr", "list" } },
+        { "cc_parallel", true, true, { "csr", "list" } },
+        { "cc_afforest", true, true, { "csr" } },
+        { "johnson", true, false, { "csr" } },
+        { "dijkstra", false, true, { "csr" } },
+        { "delta_stepping", true, true, { "csr" } },
+    };
+    return algorithms;
+}
+
+const BenchAlgorithm& bench_algorithm(const string& name)
+{
+    for (const BenchAlgorithm& algorithm : bench_algorithms())
+        if (name == algorithm.name)
+            return algorithm;
+    throw invalid_argument("Unknown algorithm '" + name + "'");
+}
+
+BenchGraph bench_graph(const StoredGraph& stored, const string& representation)
+{
+    BenchGraph graph;
+    if (representation == "matrix") graph.matrix = stored_matrix(stored);
+    else graph.csr = stored_csr(stored);
+    if (representation == "list") graph.list = csr_to_list(*graph.csr);
+    graph.num_vert = stored.num_vert();
+    graph.num_edges = stored.csr ? stored.csr->num_edges() : stored_csr(stored)->num_edges();
+    return graph;
+}
+
+function<double(int)> bench_runner(const BenchAlgorithm& algorithm, const string& representation,
+                                   const BenchGraph& graph)
+{
+    using Kernel = function<void(int, ProgressControl*)>;
+    auto kernel_time = [](Kernel kernel) -> function<double(int)> {
+        return [kernel](int threads) {
+            ProgressControl control;
+            kernel(threads, &control);
+            return control.kernel_ms.load();
+        };
+    };
+    auto wall_time = [](function<void(int)> call) -> function<double(int)> {
+        return [call](int threads) {
+            auto start = chrono::steady_clock::now();
+            call(threads);
+            return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        };
+    };
+
+    string name = algorithm.name;
+    if (name == "floyd") return kernel_time([&](int, ProgressControl* p) { floyd_algorithm(*graph.matrix, p); });
+    if (name == "floyd_parallel")
+        return kernel_time([&](int t, ProgressControl* p) { floyd_algorithm_parallel(*graph.matrix, t, p); });
+    if (name == "floyd_blocked")
+        return kernel_time([&](int t, ProgressControl* p) {
+            floyd_algorithm_blocked(*graph.matrix, t, DEFAULT_FLOYD_TILE_SIZE, p);
+        });
+    if (name == "cc_afforest")
+        return kernel_time([&](int t, ProgressControl* p) { connected_components_afforest(*graph.csr, t, 2, p); });
+    if (name == "johnson")
+        return kernel_time([&](int t, ProgressControl* p) { johnson_algorithm(*graph.csr, t, p); });
+    if (name == "dijkstra")
+        return kernel_time([&](int, ProgressControl* p) { dijkstra_sssp(*graph.csr, { 0 }, p); });
+    if (name == "delta_stepping")
+        return kernel_time([&](int t, ProgressControl* p) { delta_stepping_sssp(*graph.csr, { 0 }, t, 0, p); });
+    if (representation == "list") {
+        if (name == "cc") return wall_time([&](int) { connected_components_algorithm(graph.list); });
+        return wall_time([&](int t) { connected_components_algorithm_parallel(graph.list, t); });
+    }
+    if (name == "cc")
+        return kernel_time([&](int, ProgressControl* p) { connected_components_algorithm(*graph.csr, p); });
+    return kernel_time([&](int t, ProgressControl* p) { connected_components_algorithm_parallel(*graph.csr, t, p); });
+}
+
+TimingSummary time_runs(const function<double(int)>& run, int threads, int warmup, int trials, vector<double>* times_ms)
+{
+    for (int w = 0; w < warmup; w++)
+        run(threads);
+
+    vector<double> times;
+    for (int t = 0; t < trials; t++)
+        times.push_back(run(threads));
+    if (times_ms)
+        *times_ms = times;
+    return summarize_timings(move(times));
+}
+
+vector<int> scaling_thread_counts(int max_threads)
+{
+    vector<int> threads;
+    for (int p = 1; p < max_threads; p *= 2)
+        threads.push_back(p);
+    threads.push_back(max(1, max_threads));
+    return threads;
+}
+
+// clamped to the budget, deduplicated and always starting at 1
+static vector<int> sweep_threads(vector<int> threads, int warmup, int trials)
+{
+    if (warmup < 0 || trials < 1)
+        throw invalid_argument("Scaling needs warmup >= 0 and trials >= 1");
+
+    int capacity = thread_budget().capacity();
+    if (threads.empty())
+        return scaling_thread_counts(capacity);
+    for (int& p : threads) {
+        if (p < 1)
+            throw invalid_argument("Thread counts must be positive");
+        p = min(p, capacity);
+    }
+    threads.push_back(1);
+    sort(threads.begin(), threads.end());
+    threads.erase(unique(threads.begin(), threads.end()), threads.end());
+    return threads;
+}
+
+static ScalingPoint measure(const BenchAlgorithm& algorithm, const BenchGraph& graph, int threads, int warmup,
+                            int trials)
+{
+    auto run = bench_runner(algorithm, algorithm.representations[0], graph);
+    ScalingPoint point{ threads, algorithm.parallel ? thread_budget().team_size(threads) : 1,
+                        graph.num_vert, graph.num_edges, time_runs(run, threads, warmup, trials), 0.0, 0.0, 0.0 };
+    return point;
+}
+
+static double point_work(const BenchAlgorithm& algorithm, const ScalingPoint& point)
+{
+    double n = static_cast<double>(point.num_vert);
+    return algorithm.edge_based ? static_cast<double>(point.num_edges) : n * n * n;
+}
+
+// fills speedup, efficiency and karp-flatt against the one-thread point; weak scaling scales the
+// time ratio by the work ratio (gustafson's scaled speedup)
+static void finish_curve(const BenchAlgorithm& algorithm, ScalingCurve& curve, bool weak)
+{
+    const ScalingPoint& base = curve.points.front();
+    double base_work = point_work(algorithm, base);
+    for (ScalingPoint& point : curve.points) {
+        if (point.kernel.median_ms <= 0 || base.kernel.median_ms <= 0 || base_work <= 0)
+            continue;
+        double work_ratio = weak ? point_work(algorithm, point) / base_work : 1.0;
+        double p = point.effective_threads;
+        point.speedup = work_ratio * base.kernel.median_ms / point.kernel.median_ms;
+        point.efficiency = point.speedup / p;
+        point.karp_flatt = p > 1 ? (1.0 / point.speedup - 1.0 / p) / (1.0 - 1.0 / p) : 0.0;
+    }
+}
+
+vector<ScalingCurve> strong_scaling(const StoredGraph& graph, const vector<string>& algorithms, vector<int> threads,
+                                    int warmup, int trials)
+{
+    threads = sweep_threads(move(threads), warmup, trials);
+
+    // converted once per representation and shared by the algorithms reading it
+    map<string, BenchGraph> graphs;
+    vector<ScalingCurve> curves;
+    for (const string& name : algorithms) {
+        const BenchAlgorithm& algorithm = bench_algorithm(name);
+        const string& representation = algorithm.representations[0];
+        if (!graphs.count(representation))
+            graphs[representation] = bench_graph(graph, representation);
+
+        ScalingCurve curve{ name, {} };
+        for (int p : algorithm.parallel ? threads : vector<int>{ 1 })
+            curve.points.push_back(measure(algorithm, graphs[representation], p, warmup, trials));
+        finish_curve(algorithm, curve, false);
+        curves.push_back(move(curve));
+    }
+    return curves;
+}
+
+vector<ScalingCurve> weak_scaling(const WeakScalingGraph& base, const vector<string>& algorithms, vector<int> threads,
+                                  int warmup, int trials)
+{
+    if (base.num_vert == 0)
+        throw invalid_argument("Weak scaling needs a base graph size");
+    threads = sweep_threads(move(threads), warmup, trials);
+
+    vector<ScalingCurve> curves;
+    for (const string& name : algorithms)
+        curves.push_back(ScalingCurve{ bench_algorithm(name).name, {} });
+
+    // thread counts outermost, so only the graphs of one size are alive at a time. edge-based and
+    // O(n^3) algorithms grow different graphs, even when both read the CSR
+    for (int p : threads) {
+        map<pair<string, bool>, BenchGraph> graphs;
+        for (ScalingCurve& curve : curves) {
+            const BenchAlgorithm& algorithm = bench_algorithm(curve.algorithm);
+            if (!algorithm.parallel && p != 1)
+                continue;
+
+            const string& representation = algorithm.representations[0];
+            const pair<string, bool> key(representation, algorithm.edge_based);
+            if (!graphs.count(key)) {
+                size_t n = base.num_vert * p;
+                uint64_t m = base.num_edges * p;
+                if (!algorithm.edge_based) {
+                    size_t floyd_base = base.floyd_num_vert ? base.floyd_num_vert : base.num_vert;
+                    n = static_cast<size_t>(llround(floyd_base * cbrt(static_cast<double>(p))));
+                    double scale = static_cast<double>(n) / base.num_vert;
+                    m = static_cast<uint64_t>(llround(base.num_edges * scale * scale));
+                }
+                m = min(m, max_possible_edges(n, base.directed));
+
+                StoredGraph stored;
+                GraphCSR csr = generate_graph_csr(base.generator, n, base.max_weight, m, base.directed, base.seed);
+                stored.csr = make_shared<const GraphCSR>(move(csr));
+                graphs[key] = bench_graph(stored, representation);
+            }
+            curve.points.push_back(measure(algorithm, graphs[key], p, warmup, trials));
+        }
+    }
+
+    for (ScalingCurve& curve : curves)
+        finish_curve(bench_algorithm(curve.algorithm), curve, true);
+    return curves;
+}
+
+json scaling_json(const vector<ScalingCurve>& curves)
+{
+    json curves_json = json::array();
+    for (const ScalingCurve& curve : curves) {
+        json points = json::array();
+        for (const ScalingPoint& point : curve.points) {
+            points.push_back({ {"threads", point.threads},
+                               {"effective_threads", point.effective_threads},
+                               {"num_vert", point.num_vert},
+                               {"num_edges", point.num_edges},
+                               {"median_ms", point.kernel.median_ms},
+                               {"median_low_ms", point.kernel.median_low_ms},
+                               {"median_high_ms", point.kernel.median_high_ms},
+                               {"min_ms", point.kernel.min_ms},
+                               {"speedup", point.speedup},
+                               {"efficiency", point.efficiency},
+                               {"karp_flatt", point.karp_flatt} });
+        }
+        curves_json.push_back({ {"algorithm", curve.algorithm}, {"points", points} });
+    }
+    return curves_json;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "bench_stats.h"
+#include "graph_generators.h"
+#include "graph_store.h"
+#include "json.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// one benchmarked algorithm: what it reads, whether it uses threads, how to count its work
+struct BenchAlgorithm
+{
+    const char* name;
+    bool parallel;
+    bool edge_based; // rate in GTEPS (edges / ns); otherwise relaxations per second (n^3, for johnson the floyd equivalent)
+    std::vector<std::string> representations; // the first is the default
+};
+
+// floyd, floyd_parallel, floyd_blocked, cc, cc_parallel, cc_afforest, johnson, and dijkstra and
+// delta_stepping from vertex 0
+const std::vector<BenchAlgorithm>& bench_algorithms();
+
+// throws std::invalid_argument for unknown names
+const BenchAlgorithm& bench_algorithm(const std::string& name);
+
+// the graph in the representation a run needs, converted once before timing
+struct BenchGraph
+{
+    std::shared_ptr<const GraphMatrix> matrix;
+    std::shared_ptr<const GraphCSR> csr;
+    GraphAdjList list;
+    size_t num_vert = 0;
+    size_t num_edges = 0;
+};
+
+BenchGraph bench_graph(const StoredGraph& stored, const std::string& representation);
+
+// a run takes a thread count and returns its kernel time in ms: what the algorithm reports through
+// ProgressControl, so result formatting is left out. the list variants report nothing and are timed
+// around the call. the graph must outlive the runner
+std::function<double(int)> bench_runner(const BenchAlgorithm& algorithm, const std::string& representation,
+                                        const BenchGraph& graph);
+
+// warmup untimed runs, then trials timed ones; the raw times go to times_ms when given
+TimingSummary time_runs(const std::function<double(int)>& run, int threads, int warmup, int trials,
+                        std::vector<double>* times_ms = nullptr);
+
+// 1, 2, 4, ... up to max_threads, which is always the last point
+std::vector<int> scaling_thread_counts(int max_threads);
+
+// one point of a scaling curve. speedup is against the same algorithm on one thread; for weak
+// scaling it is the scaled speedup (work ratio times time ratio). karp_flatt is the experimentally
+// determined serial fraction (1/speedup - 1/p) / (1 - 1/p), 0 on one thread
+struct ScalingPoint
+{
+    int threads;
+    int effective_threads; // what the thread budget gave the call
+    size_t num_vert;
+    size_t num_edges;
+    TimingSummary kernel;
+    double speedup;
+    double efficiency;
+    double karp_flatt;
+};
+
+struct ScalingCurve
+{
+    std::string algorithm;
+    std::vector<ScalingPoint> points;
+};
+
+// the base graph of weak scaling, sized for one thread. p threads get p times its work: p times the
+// vertices and edges for the edge-based algorithms, cbrt(p) times the vertices at the same density for
+// floyd and johnson
+struct WeakScalingGraph
+{
+    GraphGenerator generator = GraphGenerator::Uniform;
+    size_t num_vert = 0;
+    size_t floyd_num_vert = 0; // floyd's O(n^3) base size, usually far smaller; 0 means num_vert
+    uint64_t num_edges = 0;
+    int max_weight = 100;
+    bool directed = false;
+    uint64_t seed = 1;
+};
+
+// sequential algorithms get a single point on one thread. thread counts are clamped to the compute
+// budget, sorted, and 1 is added when missing so every curve has its baseline
+std::vector<ScalingCurve> strong_scaling(const StoredGraph& graph, const std::vector<std::string>& algorithms,
+                                         std::vector<int> threads, int warmup, int trials);
+
+std::vector<ScalingCurve> weak_scaling(const WeakScalingGraph& base, const std::vector<std::string>& algorithms,
+                                       std::vector<int> threads, int warmup, int trials);
+
+// {"algorithm", "points": [{"threads", "effective_threads", "num_vert", "num_edges", "median_ms", ...}]}
+nlohmann::json scaling_json(const std::vector<ScalingCurve>& curves);
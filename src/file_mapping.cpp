@@ -0,0 +1,53 @@
+#include "file_mapping.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static runtime_error io_error(const string& what, const string& path)
+{
+    return runtime_error(what + " '" + path + "': " + strerror(errno));
+}
+
+FileMapping::FileMapping(const string& path) : base(nullptr), length(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw io_error("Cannot open", path);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        errno = err;
+        throw io_error("Cannot stat", path);
+    }
+
+    // an empty file maps to nothing
+    length = st.st_size;
+    if (length > 0) {
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        int err = errno;
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            errno = err;
+            throw io_error("Cannot map", path);
+        }
+        base = static_cast<const char*>(mapped);
+    } else {
+        close(fd);
+    }
+}
+
+FileMapping::~FileMapping()
+{
+    if (base)
+        munmap(const_cast<char*>(base), length);
+}
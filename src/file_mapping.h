@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// read-only mapping of a whole file, unmapped on destruction
+class FileMapping
+{
+public:
+    // throws std::runtime_error if the file cannot be opened or mapped
+    explicit FileMapping(const std::string& path);
+    ~FileMapping();
+
+    FileMapping(const FileMapping&) = delete;
+    FileMapping& operator=(const FileMapping&) = delete;
+
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    const char* base;
+    size_t length;
+};
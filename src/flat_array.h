@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+// contiguous array that either owns its elements or views read-only memory kept alive by an
+// owner handle (e.g. a file mapping). reads never copy; the first mutable access to a view
+// copies it into owned storage, and copies of a view always own their elements
+template <typename T, typename Alloc = std::allocator<T> >
+class FlatArray
+{
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    FlatArray() : external(nullptr), external_size(0) {}
+    explicit FlatArray(size_t n, const T& fill = T()) : owned(n, fill), external(nullptr), external_size(0) {}
+    FlatArray(std::initializer_list<T> values) : owned(values), external(nullptr), external_size(0) {}
+
+    FlatArray(const FlatArray& other) : owned(other.begin(), other.end()), external(nullptr), external_size(0) {}
+    FlatArray(FlatArray&& other) noexcept
+        : owned(std::move(other.owned)), external(other.external), external_size(other.external_size),
+          keep_alive(std::move(other.keep_alive))
+    {
+        other.release();
+    }
+
+    FlatArray& operator=(const FlatArray& other)
+    {
+        if (this != &other)
+            *this = FlatArray(other);
+        return *this;
+    }
+    FlatArray& operator=(FlatArray&& other) noexcept
+    {
+        owned = std::move(other.owned);
+        external = other.external;
+        external_size = other.external_size;
+        keep_alive = std::move(other.keep_alive);
+        other.release();
+        return *this;
+    }
+
+    // read-only view of n elements at data; owner keeps the memory valid
+    static FlatArray view(const T* data, size_t n, std::shared_ptr<const void> owner)
+    {
+        FlatArray array;
+        array.external = data;
+        array.external_size = n;
+        array.keep_alive = std::move(owner);
+        return array;
+    }
+
+    bool is_view() const { return external != nullptr; }
+    // heap bytes held by this array; views cost nothing here
+    size_t owned_bytes() const { return owned.size() * sizeof(T); }
+
+    size_t size() const { return external ? external_size : owned.size(); }
+    bool empty() const { return size() == 0; }
+
+    const T* data() const { return external ? external : owned.data(); }
+    T* data() { own(); return owned.data(); }
+
+    const T& operator[](size_t i) const { return data()[i]; }
+    T& operator[](size_t i) { return data()[i]; }
+
+    const T& back() const { return data()[size() - 1]; }
+    T& back() { return data()[size() - 1]; }
+
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size(); }
+    iterator begin() { return data(); }
+    iterator end() { return data() + size(); }
+
+    void resize(size_t n) { own(); owned.resize(n); }
+    void reserve(size_t n) { own(); owned.reserve(n); }
+    void assign(size_t n, const T& fill) { release(); owned.assign(n, fill); }
+    void push_back(const T& value) { own(); owned.push_back(value); }
+    void clear() { release(); owned.clear(); }
+
+    bool operator==(const FlatArray& other) const { return std::equal(begin(), end(), other.begin(), other.end()); }
+    bool operator!=(const FlatArray& other) const { return !(*this == other); }
+
+    template <typename A>
+    bool operator==(const std::vector<T, A>& other) const { return std::equal(begin(), end(), other.begin(), other.end()); }
+
+private:
+    void own()
+    {
+        if (!external) return;
+        owned.assign(external, external + external_size);
+        release();
+    }
+
+    void release()
+    {
+        external = nullptr;
+        external_size = 0;
+        keep_alive.reset();
+    }
+
+    std::vector<T, Alloc> owned;
+    const T* external;
+    size_t external_size;
+    std::shared_ptr<const void> keep_alive;
+};
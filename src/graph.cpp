@@ -1,4 +1,8 @@
 #include "graph.h"
+#include "graph_generators.h"
+#include "minplus.h"
+#include "thread_budget.h"
+#include "trace.h"
 
 #include <iostream>
 #include <fstream>
@@ -16,105 +20,36 @@
 using namespace std;
 using namespace std::chrono;
 
-GraphMatrix generate_random_graph_matrix(size_t num_vert, int max_weight, int num_edges, bool isDirected) 
+GraphMatrix generate_random_graph_matrix(size_t num_vert, int max_weight, int num_edges, bool isDirected, uint64_t seed)
 {
-    static bool initialized = false;
-    if (!initialized) {
-        srand(static_cast<unsigned int>(time(nullptr)));
-        initialized = true;
-    }
-
-    size_t max_possible_edges = isDirected ? num_vert * (num_vert - 1) : num_vert * (num_vert - 1) / 2;
-    
-    if(num_edges > max_possible_edges)
-    {
-        cout << "Invalid input: too many edges requested.\n";
+    if (num_edges < 0 || static_cast<uint64_t>(num_edges) > max_possible_edges(num_vert, isDirected))
         return GraphMatrix(); // invalid graph
-    }
-
-    GraphMatrix graph(num_vert);
 
-    int edges_added = 0;
-    while (edges_added < static_cast<int>(num_edges)) 
-    {
-        size_t u = rand() % num_vert;
-        size_t v = rand() % num_vert;
-        int weight = 1 + rand() % max_weight;
-
-        if (u != v && graph.weight_matrix[u][v] == INF) 
-        {
-            graph.weight_matrix[u][v] = weight;
-            if(!isDirected) graph.weight_matrix[v][u] = weight;
-            edges_added++;
-        }
-    }
-
-    return graph;
+    GraphCSR csr = generate_random_graph_csr(num_vert, max_weight, num_edges, isDirected, seed ? seed : random_seed());
+    return csr_to_matrix(csr);
 }
 
-GraphAdjList generate_random_graph_list(size_t num_vert, int max_weight, int num_edges, bool isDirected)
+GraphAdjList generate_random_graph_list(size_t num_vert, int max_weight, int num_edges, bool isDirected, uint64_t seed)
 {
-    static bool initialized = false;
-    if (!initialized) {
-        srand(static_cast<unsigned int>(time(nullptr)));
-        initialized = true;
-    }
-
-    size_t max_possible_edges = isDirected ? num_vert * (num_vert - 1) : num_vert * (num_vert - 1) / 2;
-    
-    if(num_edges > max_possible_edges)
-    {
-        cout << "Invalid input: too many edges requested.\n";
+    if (num_edges < 0 || static_cast<uint64_t>(num_edges) > max_possible_edges(num_vert, isDirected))
         return GraphAdjList(); // invalid graph
-    }
-
-    GraphAdjList graph(num_vert);
-
-    int edges_added = 0;
-    while (edges_added < static_cast<int>(num_edges))
-    {
-        size_t from = rand() % num_vert;
-        size_t to = rand() % num_vert;
-
-        if (from != to)
-        {
-            int weight = 1 + rand() % max_weight;
-
-            bool edge_exists = false;
-            for (const auto& neighbor : graph.adjList[from])
-            {
-                if (neighbor.first == to)
-                {
-                    edge_exists = true;
-                    break;
-                }
-            }
-
-            if (!edge_exists)
-            {
-                graph.adjList[from].push_back(std::make_pair(to, weight));
-                if (!isDirected)
-                    graph.adjList[to].push_back(std::make_pair(from, weight));
-                edges_added++;
-            }
-        }
-    }
 
-    return graph;
+    return csr_to_list(generate_random_graph_csr(num_vert, max_weight, num_edges, isDirected, seed ? seed : random_seed()));
 }
 
 void print_matrix(const Matrix& matrix, bool benchmark) 
 {
     if (benchmark) return;
 
-    for (const auto& row : matrix) 
+    for (size_t i = 0; i < matrix.size(); ++i) 
     {
-        for (int val : row) 
+        const int* row = matrix[i];
+        for (size_t j = 0; j < matrix.size(); ++j) 
         {
-            if (val == INF)
+            if (row[j] == INF)
                 cout << "- ";
             else
-                cout << val << " ";
+                cout << row[j] << " ";
         }
         cout << "\n";
     }
@@ -186,205 +121,423 @@ GraphMatrix list_to_matrix(const GraphAdjList& list)
     return matrix;
 }
 
-// floyd-warshall sequential
-pair<Matrix, string> floyd_algorithm(const GraphMatrix& graph)
+template <typename VertexId>
+BasicGraphCSR<VertexId> list_to_csr(const GraphAdjList& list)
 {
-    auto start_time = high_resolution_clock::now();
-    
-    Matrix dist = graph.weight_matrix;
-    stringstream result;
-    
-    result << "Floyd-Warshall Algorithm (All Pairs Shortest Paths)\n";
-    result << "Graph size: " << graph.num_vert << " vertices\n";
-    result << "Time complexity: O(V³) = O(" << graph.num_vert << "³) = O(" << 
-              (graph.num_vert * graph.num_vert * graph.num_vert) << ")\n\n";
+    if (!list.valid)
+        return BasicGraphCSR<VertexId>();
 
-    // show initial matrix only for small graphs
-    if (graph.num_vert <= 20) 
+    BasicGraphCSR<VertexId> csr(list.num_vert);
+
+    for(size_t i = 0; i < list.num_vert; i++)
+        csr.offsets[i + 1] = csr.offsets[i] + list.adjList[i].size();
+
+    csr.neighbors.resize(csr.offsets[list.num_vert]);
+    csr.weights.resize(csr.offsets[list.num_vert]);
+
+    // every vertex owns a disjoint slice, so rows are filled independently
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for(size_t i = 0; i < list.num_vert; i++)
     {
-        result << "Initial distance matrix:\n";
-        for (const auto& row : dist) 
+        uint64_t pos = csr.offsets[i];
+        for(const auto& edge : list.adjList[i])
         {
-            for (int val : row) 
-            {
-                if (val == INF)
-                    result << "∞ ";
-                else
-                    result << val << " ";
-            }
-            result << "\n";
+            csr.neighbors[pos] = static_cast<VertexId>(edge.first);
+            csr.weights[pos] = edge.second;
+            pos++;
         }
-        result << "\n";
     }
-    
-    // show only execution time
-    auto algorithm_start = high_resolution_clock::now();
-    
-    for(size_t k = 0; k < graph.num_vert; k++)
+    return csr;
+}
+
+// diagonal entries are distances to self, not edges, and are skipped
+template <typename VertexId>
+BasicGraphCSR<VertexId> matrix_to_csr(const GraphMatrix& matrix)
+{
+    if (!matrix.valid)
+        return BasicGraphCSR<VertexId>();
+
+    const size_t n = matrix.num_vert;
+    BasicGraphCSR<VertexId> csr(n);
+
+    #pragma omp parallel for schedule(static)
+    for(size_t i = 0; i < n; i++)
     {
-        for(size_t i = 0; i < graph.num_vert; i++)
+        const int* row = matrix.weight_matrix[i];
+        uint64_t count = 0;
+        for(size_t j = 0; j < n; j++)
+            count += (row[j] != INF && i != j);
+        csr.offsets[i + 1] = count;
+    }
+
+    for(size_t i = 0; i < n; i++)
+        csr.offsets[i + 1] += csr.offsets[i];
+
+    csr.neighbors.resize(csr.offsets[n]);
+    csr.weights.resize(csr.offsets[n]);
+
+    #pragma omp parallel for schedule(static)
+    for(size_t i = 0; i < n; i++)
+    {
+        const int* row = matrix.weight_matrix[i];
+        uint64_t pos = csr.offsets[i];
+        for(size_t j = 0; j < n; j++)
         {
-            for(size_t j = 0; j < graph.num_vert; j++)
+            if(row[j] != INF && i != j)
             {
-                if(dist[i][k] != INF && dist[k][j] != INF && dist[i][k] + dist[k][j] < dist[i][j])
-                {
-                    dist[i][j] = dist[i][k] + dist[k][j];
-                }
+                csr.neighbors[pos] = static_cast<VertexId>(j);
+                csr.weights[pos] = row[j];
+                pos++;
             }
         }
     }
-    
-    auto algorithm_end = high_resolution_clock::now();
-    auto end_time = high_resolution_clock::now();
-    
-    auto total_duration = duration_cast<microseconds>(end_time - start_time);
-    auto algorithm_duration = duration_cast<microseconds>(algorithm_end - algorithm_start);
-    
-    double total_time_ms = total_duration.count() / 1000.0;
-    double algorithm_time_ms = algorithm_duration.count() / 1000.0;
+    return csr;
+}
 
-    // show final matrix only for small graphs
-    if (graph.num_vert <= 20) 
+template <typename VertexId>
+GraphMatrix csr_to_matrix(const BasicGraphCSR<VertexId>& csr)
+{
+    if (!csr.valid)
+        return GraphMatrix();
+
+    GraphMatrix matrix(csr.num_vert);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(size_t i = 0; i < csr.num_vert; i++)
+    {
+        int* row = matrix.weight_matrix[i];
+        for(uint64_t e = csr.offsets[i]; e < csr.offsets[i + 1]; e++)
+            row[csr.neighbors[e]] = csr.weights[e];
+    }
+    return matrix;
+}
+
+template <typename VertexId>
+GraphAdjList csr_to_list(const BasicGraphCSR<VertexId>& csr)
+{
+    if (!csr.valid)
+        return GraphAdjList();
+
+    GraphAdjList list(csr.num_vert);
+    for(size_t i = 0; i < csr.num_vert; i++)
+    {
+        for(uint64_t e = csr.offsets[i]; e < csr.offsets[i + 1]; e++)
+            list.adjList[i].push_back(make_pair(static_cast<size_t>(csr.neighbors[e]), csr.weights[e]));
+    }
+    return list;
+}
+
+template GraphCSR list_to_csr<uint32_t>(const GraphAdjList&);
+template GraphCSR64 list_to_csr<uint64_t>(const GraphAdjList&);
+template GraphCSR matrix_to_csr<uint32_t>(const GraphMatrix&);
+template GraphCSR64 matrix_to_csr<uint64_t>(const GraphMatrix&);
+template GraphMatrix csr_to_matrix<uint32_t>(const GraphCSR&);
+template GraphMatrix csr_to_matrix<uint64_t>(const GraphCSR64&);
+template GraphAdjList csr_to_list<uint32_t>(const GraphCSR&);
+template GraphAdjList csr_to_list<uint64_t>(const GraphCSR64&);
+
+// dump a distance matrix into a report (used for small graphs only)
+static void write_distance_matrix(stringstream& result, const char* title, const Matrix& dist)
+{
+    result << title << ":\n";
+    for (size_t i = 0; i < dist.size(); i++) 
     {
-        result << "Final shortest paths matrix:\n";
-        for (const auto& row : dist) 
+        const int* row = dist[i];
+        for (size_t j = 0; j < dist.size(); j++) 
         {
-            for (int val : row) 
-            {
-                if (val == INF)
-                    result << "∞ ";
-                else
-                    result << val << " ";
-            }
-            result << "\n";
+            if (row[j] == INF)
+                result << "∞ ";
+            else
+                result << row[j] << " ";
         }
         result << "\n";
     }
+    result << "\n";
+}
+
+string floyd_report(const GraphMatrix& graph, const FloydResult& floyd)
+{
+    TraceSpan span("floyd.report");
+    const RunStats& stats = floyd.stats;
+    const size_t n = stats.num_vert;
+    stringstream result;
+
+    if (stats.algorithm == "floyd_blocked")
+        result << "Blocked Parallel Floyd-Warshall Algorithm\n";
+    else if (stats.algorithm == "floyd_parallel")
+        result << "Optimized Parallel Floyd-Warshall Algorithm\n";
+    else
+        result << "Floyd-Warshall Algorithm (All Pairs Shortest Paths)\n";
+    result << "Graph size: " << n << " vertices\n";
+    if (stats.algorithm != "floyd")
+        result << "Number of threads: " << stats.threads << "\n";
+    if (stats.tile_size > 0)
+    {
+        size_t num_tiles = (n + stats.tile_size - 1) / stats.tile_size;
+        result << "Tile size: " << stats.tile_size << " x " << stats.tile_size << " (" << num_tiles << " x " << num_tiles << " tiles)\n";
+    }
+    result << "Time complexity: O(V³) = O(" << n << "³) = O(" << (n * n * n) << ")\n\n";
+
+    // show the matrices only for small graphs
+    if (n <= 20) 
+    {
+        write_distance_matrix(result, "Initial distance matrix", graph.weight_matrix);
+        write_distance_matrix(result, "Final shortest paths matrix", floyd.dist);
+    }
     
     result << string(50, '=') << "\n";
     result << "PERFORMANCE BENCHMARK:\n";
     result << string(50, '=') << "\n";
-    result << "Algorithm execution time: " << format_time(algorithm_time_ms) << "\n";
-    result << "Total time (including I/O): " << format_time(total_time_ms) << "\n";
-    result << "Operations performed: " << (graph.num_vert * graph.num_vert * graph.num_vert) << "\n";
-    if (algorithm_time_ms > 0) 
+    result << "Algorithm execution time: " << format_time(stats.kernel_ms) << "\n";
+    result << "Total time (including I/O): " << format_time(stats.total_ms) << "\n";
+    result << "SIMD kernel: " << simd_isa_name(detect_simd_isa()) << "\n";
+    result << "Operations performed: " << (n * n * n) << "\n";
+    if (stats.kernel_ms > 0) 
     {
         result << "Operations per second: " << fixed << setprecision(0) << 
-                  (graph.num_vert * graph.num_vert * graph.num_vert * 1000.0 / algorithm_time_ms) << "\n";
+                  (n * n * n * 1000.0 / stats.kernel_ms) << "\n";
     }
+    result << perf_report(stats.counters);
 
-    return make_pair(dist, result.str());
+    return result.str();
 }
 
-// connected components DFS helper func
-void connected_comp_DFS(const GraphAdjList& graph, size_t vert, std::vector<bool>& isVisited, std::vector<int>& comp)
+// floyd-warshall sequential; progress counts finished k iterations
+FloydResult floyd_algorithm(const GraphMatrix& graph, ProgressControl* progress)
 {
-    isVisited[vert] = true;
-    comp.push_back(vert);
-    for(const auto& neighbor : graph.adjList[vert])
-    {
-        size_t neighbor_vert = neighbor.first;
-        if(!isVisited[neighbor_vert])
-            connected_comp_DFS(graph, neighbor_vert, isVisited, comp);
-    }
-}
+    // a sequential run still occupies one core of the compute budget
+    ThreadTeam team(1);
 
-// sequential connected components
-pair<vector<vector<int>>, string> connected_components_algorithm(const GraphAdjList& graph)
-{
     auto start_time = high_resolution_clock::now();
     
-    stringstream result;
-    result << "Connected Components Algorithm (DFS-based)\n";
-    result << "Graph size: " << graph.num_vert << " vertices\n";
+    TraceSpan copy_span("floyd.copy");
+    Matrix dist = graph.weight_matrix;
+    copy_span.end();
     
-    // count edges
-    size_t edge_count = 0;
-    for (size_t i = 0; i < graph.num_vert; ++i) 
+    PerfCounters counters(progress_wants_counters(progress), team.size());
+    TraceSpan kernel_span("floyd.kernel");
+    auto algorithm_start = high_resolution_clock::now();
+    
+    MatrixView d = dist.view();
+    progress_start(progress, graph.num_vert);
+    for(size_t k = 0; k < graph.num_vert; k++)
     {
-        edge_count += graph.adjList[i].size();
+        throw_if_cancelled(progress);
+        const int* row_k = d[k];
+        for(size_t i = 0; i < graph.num_vert; i++)
+        {
+            int* row_i = d[i];
+            const int d_ik = row_i[k];
+            if(d_ik == INF)
+                continue;
+
+            minplus_row(row_i, row_k, d_ik, graph.num_vert);
+        }
+        progress_advance(progress, 1);
     }
-    edge_count /= 2; // for undirected graphs
     
-    result << "Number of edges: " << edge_count << "\n";
-    result << "Time complexity: O(V + E) = O(" << graph.num_vert << " + " << edge_count << ") = O(" << 
-              (graph.num_vert + edge_count) << ")\n\n";
+    auto algorithm_end = high_resolution_clock::now();
+    kernel_span.end();
+
+    RunStats stats;
+    stats.algorithm = "floyd";
+    stats.num_vert = graph.num_vert;
+    stats.threads = team.size();
+    stats.counters = counters.stop();
+    stats.kernel_ms = duration_cast<microseconds>(algorithm_end - algorithm_start).count() / 1000.0;
+    stats.total_ms = duration_cast<microseconds>(high_resolution_clock::now() - start_time).count() / 1000.0;
+    progress_kernel_time(progress, stats.kernel_ms);
+    progress_counters(progress, stats.counters);
+
+    return FloydResult{ move(dist), move(stats) };
+}
+
+// label of a vertex the sequential sweep has not reached yet
+template <typename VertexId>
+static const VertexId UNLABELED = static_cast<VertexId>(-1);
+
+// edges scanned between progress updates and cancellation checks in the sequential sweep
+static const uint64_t CC_PROGRESS_STEP = 1 << 16;
+
+// breadth-first sweep from root; the component's slice of the output array doubles as the queue,
+// so no recursion or extra frontier storage is needed
+template <typename VertexId>
+static void connected_comp_BFS(const BasicGraphCSR<VertexId>& graph, size_t root, VertexId comp_id,
+                               std::vector<VertexId>& label, std::vector<int>& vertices,
+                               ProgressControl* progress)
+{
+    size_t head = vertices.size();
+    label[root] = comp_id;
+    vertices.push_back(root);
+    uint64_t scanned = 0;
+
+    while (head < vertices.size())
+    {
+        size_t vert = vertices[head++];
+        if (progress && (scanned += graph.degree(vert)) >= CC_PROGRESS_STEP)
+        {
+            progress->advance(scanned);
+            scanned = 0;
+            throw_if_cancelled(progress);
+        }
+        for(uint64_t e = graph.offsets[vert]; e < graph.offsets[vert + 1]; e++)
+        {
+            VertexId neighbor_vert = graph.neighbors[e];
+            if(label[neighbor_vert] == UNLABELED<VertexId>)
+            {
+                label[neighbor_vert] = comp_id;
+                vertices.push_back(neighbor_vert);
+            }
+        }
+    }
+    progress_advance(progress, scanned);
+}
+
+// sequential connected components
+ComponentsResult connected_components_algorithm(const GraphAdjList& graph)
+{
+    return connected_components_algorithm(list_to_csr(graph));
+}
+
+// progress counts scanned edges
+template <typename VertexId>
+ComponentsResult connected_components_algorithm(const BasicGraphCSR<VertexId>& graph, ProgressControl* progress)
+{
+    ThreadTeam team(1);
+
+    auto start_time = high_resolution_clock::now();
     
-    // execution time only
+    PerfCounters counters(progress_wants_counters(progress), team.size());
+    TraceSpan kernel_span("cc.kernel");
     auto algorithm_start = high_resolution_clock::now();
     
-    vector<vector<int>> connected_components;
-    vector<bool> isVisited(graph.num_vert, false);
+    ComponentList connected_components;
+    connected_components.vertices.reserve(graph.num_vert);
+    vector<VertexId> label(graph.num_vert, UNLABELED<VertexId>);
+    progress_start(progress, graph.num_edges());
     
     for (size_t i = 0; i < graph.num_vert; ++i)
     {
-        if (!isVisited[i])
+        if (label[i] == UNLABELED<VertexId>)
         {
-            vector<int> component;
-            connected_comp_DFS(graph, i, isVisited, component);
-            connected_components.push_back(component);
+            VertexId comp_id = static_cast<VertexId>(connected_components.size());
+            connected_comp_BFS(graph, i, comp_id, label, connected_components.vertices, progress);
+            connected_components.offsets.push_back(connected_components.vertices.size());
         }
     }
     
     auto algorithm_end = high_resolution_clock::now();
-    auto end_time = high_resolution_clock::now();
-    
-    auto total_duration = duration_cast<microseconds>(end_time - start_time);
-    auto algorithm_duration = duration_cast<microseconds>(algorithm_end - algorithm_start);
-    
-    double total_time_ms = total_duration.count() / 1000.0;
-    double algorithm_time_ms = algorithm_duration.count() / 1000.0;
-    
-    // show connected components only for small graphs
-    if (graph.num_vert <= 20) 
+    kernel_span.end();
+
+    RunStats stats;
+    stats.algorithm = "cc";
+    stats.num_vert = graph.num_vert;
+    stats.num_edges = graph.num_edges() / 2; // for undirected graphs
+    stats.threads = team.size();
+    stats.counters = counters.stop();
+    stats.kernel_ms = duration_cast<microseconds>(algorithm_end - algorithm_start).count() / 1000.0;
+    stats.total_ms = duration_cast<microseconds>(high_resolution_clock::now() - start_time).count() / 1000.0;
+    progress_kernel_time(progress, stats.kernel_ms);
+    progress_counters(progress, stats.counters);
+
+    return ComponentsResult{ move(connected_components), move(stats) };
+}
+
+// the sequential BFS report, or the shorter one the parallel variants share
+string components_report(const ComponentsResult& cc)
+{
+    TraceSpan span("components.report");
+    const RunStats& stats = cc.stats;
+    const ComponentList& components = cc.components;
+    stringstream result;
+
+    if (stats.algorithm == "cc")
     {
-        result << "Connected Components found:\n";
-        for (size_t i = 0; i < connected_components.size(); ++i) 
+        result << "Connected Components Algorithm (BFS-based)\n";
+        result << "Graph size: " << stats.num_vert << " vertices\n";
+        result << "Number of edges: " << stats.num_edges << "\n";
+        result << "Time complexity: O(V + E) = O(" << stats.num_vert << " + " << stats.num_edges << ") = O(" << 
+                  (stats.num_vert + stats.num_edges) << ")\n\n";
+
+        // show connected components only for small graphs
+        if (stats.num_vert <= 20) 
         {
-            result << "Component " << (i + 1) << ": ";
-            for (size_t j = 0; j < connected_components[i].size(); ++j) 
+            result << "Connected Components found:\n";
+            for (size_t i = 0; i < components.size(); ++i) 
             {
-                result << connected_components[i][j];
-                if (j < connected_components[i].size() - 1) result << " ";
+                result << "Component " << (i + 1) << ": ";
+                for (size_t j = 0; j < components[i].size(); ++j) 
+                {
+                    result << components[i][j];
+                    if (j < components[i].size() - 1) result << " ";
+                }
+                result << " (size: " << components[i].size() << ")\n";
             }
-            result << " (size: " << connected_components[i].size() << ")\n";
+            result << "\n";
         }
-        result << "\n";
-    }
-    
-    result << "Statistics:\n";
-    result << "Number of connected components: " << connected_components.size() << "\n";
-    result << "Largest component size: ";
-    if (!connected_components.empty()) 
-    {
-        size_t max_size = 0;
-        for (const auto& comp : connected_components) 
+        
+        result << "Statistics:\n";
+        result << "Number of connected components: " << components.size() << "\n";
+        result << "Largest component size: " << components.largest_size() << "\n";
+        
+        result << string(50, '=') << "\n";
+        result << "PERFORMANCE BENCHMARK:\n";
+        result << string(50, '=') << "\n";
+        result << "Algorithm execution time: " << format_time(stats.kernel_ms) << "\n";
+        result << "Total time (including I/O): " << format_time(stats.total_ms) << "\n";
+        result << "Vertices processed: " << stats.num_vert << "\n";
+        result << "Edges processed: " << stats.num_edges << "\n";
+        if (stats.kernel_ms > 0) 
         {
-            max_size = max(max_size, comp.size());
+            result << "Vertices per second: " << fixed << setprecision(0) << 
+                      (stats.num_vert * 1000.0 / stats.kernel_ms) << "\n";
         }
-        result << max_size << "\n";
-    } else {
-        result << "0\n";
+        result << perf_report(stats.counters);
+        
+        if (components.size() == 1) {
+            result << "✓ Graph is connected\n";
+        } else {
+            result << "⚠ Graph has " << components.size() << " disconnected components\n";
+        }
+        return result.str();
     }
-    
-    result << string(50, '=') << "\n";
-    result << "PERFORMANCE BENCHMARK:\n";
-    result << string(50, '=') << "\n";
-    result << "Algorithm execution time: " << format_time(algorithm_time_ms) << "\n";
-    result << "Total time (including I/O): " << format_time(total_time_ms) << "\n";
-    result << "Vertices processed: " << graph.num_vert << "\n";
-    result << "Edges processed: " << edge_count << "\n";
-    if (algorithm_time_ms > 0) 
+
+    if (stats.algorithm == "cc_afforest")
+        result << "Afforest Parallel Connected Components\n";
+    else
+        result << "Optimized Parallel Connected Components\n";
+    result << "Graph size: " << stats.num_vert << " vertices\n";
+    result << "Number of threads: " << stats.threads << "\n";
+    result << "Number of edges: " << stats.num_edges << "\n";
+    if (stats.algorithm == "cc_afforest")
     {
-        result << "Vertices per second: " << fixed << setprecision(0) << 
-                  (graph.num_vert * 1000.0 / algorithm_time_ms) << "\n";
+        result << "Sampled neighbor rounds: " << stats.neighbor_rounds << "\n";
+        result << "Sampled giant component share: " << fixed << setprecision(1) << (stats.giant_fraction * 100.0) << "%\n";
+        result << "Vertices skipped in final phase: " << stats.skipped_vertices << "\n";
     }
     
-    if (connected_components.size() == 1) {
-        result << "✓ Graph is connected\n";
+    result << "\nPerformance Metrics:\n";
+    result << "Execution time: " << fixed << setprecision(3) << stats.kernel_ms << " ms\n";
+    result << "Number of components: " << components.size() << "\n";
+    result << perf_report(stats.counters);
+    
+    if (stats.num_vert <= 20) 
+    {
+        result << "\nComponents:\n";
+        for (size_t i = 0; i < components.size(); ++i) 
+        {
+            result << "Component " << i << " (size " << components[i].size() << "): ";
+            for (int v : components[i]) 
+            {
+                result << v << " ";
+            }
+            result << "\n";
+        }
     } else {
-        result << "⚠ Graph has " << connected_components.size() << " disconnected components\n";
+        result << "Largest component size: " << components.largest_size() << "\n";
     }
+    return result.str();
+}
 
-    return make_pair(connected_components, result.str());
-}
\ No newline at end of file
+template ComponentsResult connected_components_algorithm<uint32_t>(const GraphCSR&, ProgressControl*);
+template ComponentsResult connected_components_algorithm<uint64_t>(const GraphCSR64&, ProgressControl*);
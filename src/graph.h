@@ -1,24 +1,31 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
 #include <list>
 #include <utility>
 #include <iostream>
 #include <climits>
+#include <cstdint>
 #include <cstdlib>
 #include <ctime>
 #include <string>
 
-typedef std::vector<std::vector<int> > Matrix;
+#include "matrix.h"
+#include "progress.h"
+
 const int INF = INT_MAX / 2;
 
+// finite weights stay strictly between -INF and INF, so adding two never overflows an int
+inline bool weight_in_range(int64_t weight) { return weight > -INF && weight < INF; }
+
 struct GraphMatrix 
 {
     size_t num_vert;
     Matrix weight_matrix;
     bool valid;
 
-    GraphMatrix(size_t num_vert) : num_vert(num_vert), weight_matrix(num_vert, std::vector<int>(num_vert, INF)), valid(true) 
+    GraphMatrix(size_t num_vert) : num_vert(num_vert), weight_matrix(num_vert, INF), valid(true) 
     {
         for (size_t i = 0; i < num_vert; ++i)
             weight_matrix[i][i] = 0;
@@ -37,14 +44,125 @@ struct GraphAdjList
     GraphAdjList() : num_vert(0), valid(false) {}
 };
 
-GraphMatrix generate_random_graph_matrix(size_t num_vert, int max_weight, int num_edges, bool isDirected = false);
-GraphAdjList generate_random_graph_list(size_t num_vert, int max_weight, int num_edges, bool isDirected = false);
+// compressed sparse row graph: the edges of v are neighbors/weights[offsets[v] .. offsets[v + 1]).
+// the arrays may be read-only views into a mapped graph file
+template <typename VertexId>
+struct BasicGraphCSR
+{
+    typedef VertexId vertex_type;
+
+    size_t num_vert;
+    FlatArray<uint64_t> offsets;
+    FlatArray<VertexId> neighbors;
+    FlatArray<int> weights;
+    bool valid;
+
+    BasicGraphCSR(size_t num_vert) : num_vert(num_vert), offsets(num_vert + 1, 0), valid(true) {}
+    BasicGraphCSR() : num_vert(0), offsets(1, 0), valid(false) {}
+
+    size_t num_edges() const { return neighbors.size(); }
+    size_t owned_bytes() const { return offsets.owned_bytes() + neighbors.owned_bytes() + weights.owned_bytes(); }
+    size_t degree(size_t v) const { return offsets[v + 1] - offsets[v]; }
+};
+
+// 32-bit vertex ids halve the neighbor array; GraphCSR64 is only needed past 4G vertices
+typedef BasicGraphCSR<uint32_t> GraphCSR;
+typedef BasicGraphCSR<uint64_t> GraphCSR64;
+
+inline bool csr_fits_32bit(size_t num_vert) { return num_vert <= UINT32_MAX; }
+
+// connected components in one flat array: component c is vertices[offsets[c] .. offsets[c + 1])
+struct ComponentList
+{
+    std::vector<int> vertices;
+    std::vector<size_t> offsets;
+
+    // read-only view of one component's vertices
+    struct Component
+    {
+        const int* first;
+        const int* last;
+
+        size_t size() const { return last - first; }
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        int operator[](size_t i) const { return first[i]; }
+    };
+
+    ComponentList() : offsets(1, 0) {}
+
+    size_t size() const { return offsets.size() - 1; }
+    bool empty() const { return size() == 0; }
+
+    Component operator[](size_t c) const
+    {
+        return Component{ vertices.data() + offsets[c], vertices.data() + offsets[c + 1] };
+    }
+
+    size_t largest_size() const
+    {
+        size_t max_size = 0;
+        for (size_t c = 0; c < size(); ++c)
+            max_size = std::max(max_size, offsets[c + 1] - offsets[c]);
+        return max_size;
+    }
+};
+
+// what one algorithm run measured. the algorithms only fill this in; floyd_report and
+// components_report turn it into text when a caller actually wants a report
+struct RunStats
+{
+    std::string algorithm;       // graph_bench name: floyd, floyd_parallel, floyd_blocked, cc, cc_parallel, cc_afforest
+                                 // or johnson, dijkstra, delta_stepping
+    size_t num_vert = 0;
+    uint64_t num_edges = 0;      // undirected edges for connected components, CSR edges for shortest paths
+    int threads = 1;             // team the run actually got
+    double kernel_ms = 0;        // the algorithm alone
+    double total_ms = 0;         // including copying the input
+    size_t tile_size = 0;        // floyd_blocked
+    int neighbor_rounds = 0;     // cc_afforest
+    double giant_fraction = 0;   // cc_afforest: sampled share of the giant intermediate component
+    size_t skipped_vertices = 0; // cc_afforest: vertices the finish phase skipped
+    size_t num_sources = 0;      // dijkstra, delta_stepping
+    uint64_t delta = 0;          // delta_stepping: bucket width
+    PerfCounts counters;
+};
+
+struct FloydResult
+{
+    Matrix dist;
+    RunStats stats;
+};
+
+struct ComponentsResult
+{
+    ComponentList components;
+    RunStats stats;
+};
+
+// human-readable reports; graphs of up to 20 vertices also list their matrices or components
+std::string floyd_report(const GraphMatrix& graph, const FloydResult& result);
+std::string components_report(const ComponentsResult& result);
+
+// seed 0 picks a fresh seed; see generate_random_graph_csr in graph_generators.h
+GraphMatrix generate_random_graph_matrix(size_t num_vert, int max_weight, int num_edges, bool isDirected = false, uint64_t seed = 0);
+GraphAdjList generate_random_graph_list(size_t num_vert, int max_weight, int num_edges, bool isDirected = false, uint64_t seed = 0);
 void print_matrix(const Matrix& matrix, bool benchmark = false);
 void print_adjList(const GraphAdjList& graph, bool benchmark = false);
 void add_edge_matrix(GraphMatrix& graph, size_t from, size_t to, int weight, int offset = 0, bool isDirected = true);
 void add_edge_adjList(GraphAdjList& graph, size_t from, size_t to, int weight, int offset = 0, bool isDirected = true);
-std::pair<Matrix, std::string> floyd_algorithm(const GraphMatrix& graph);
-std::pair<std::vector<std::vector<int> >, std::string> connected_components_algorithm(const GraphAdjList& graph);
+FloydResult floyd_algorithm(const GraphMatrix& graph, ProgressControl* progress = nullptr);
+ComponentsResult connected_components_algorithm(const GraphAdjList& graph);
+template <typename VertexId>
+ComponentsResult connected_components_algorithm(const BasicGraphCSR<VertexId>& graph, ProgressControl* progress = nullptr);
 GraphAdjList matrix_to_list(const GraphMatrix& matrix);
 GraphMatrix list_to_matrix(const GraphAdjList& list);
+template <typename VertexId = uint32_t>
+BasicGraphCSR<VertexId> list_to_csr(const GraphAdjList& list);
+template <typename VertexId = uint32_t>
+BasicGraphCSR<VertexId> matrix_to_csr(const GraphMatrix& matrix);
+template <typename VertexId>
+GraphMatrix csr_to_matrix(const BasicGraphCSR<VertexId>& csr);
+template <typename VertexId>
+GraphAdjList csr_to_list(const BasicGraphCSR<VertexId>& csr);
 std::string format_time(double time_ms);
\ No newline at end of file
@@ -0,0 +1,311 @@
+// graph_bench: times one algorithm on one graph over a sweep of thread counts, without the server
+//
+//   graph_bench --algorithm <name> [--representation matrix|csr|list]
+//               (--graph <file> [--format snap|mtx|dimacs] [--symmetrize] |
+//                --generator <family> --vertices <n> [--edges <m>] [--max-weight <w>] [--directed] [--seed <s>])
+//               [--threads 1,2,4] [--warmup 1] [--trials 5] [--output <results.json|results.csv>]
+//   graph_bench --scaling strong|weak [--algorithm <name,name,...>] <graph as above> [--floyd-vertices <n>]
+//               [--threads ...] ...
+//
+// algorithms: floyd, floyd_parallel, floyd_blocked (matrix); cc, cc_parallel (csr or list); cc_afforest,
+// johnson, dijkstra and delta_stepping (csr). every thread count gets untimed warmup runs, then trials timing the kernel alone.
+// a summary table goes to stdout and, with --output, every run to a JSON or CSV file (picked by the extension).
+// --scaling runs the listed algorithms (default all) over the sweep (default 1, 2, 4, ... all cores) and
+// reports speedup, efficiency and the karp-flatt serial fraction; weak scaling grows the generated graph
+// with the thread count, so the generator options give its one-thread size (--floyd-vertices for floyd)
+#include "benchmark.h"
+#include "graph_loaders.h"
+#include "json.hpp"
+#include "thread_budget.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+using json = nlohmann::json;
+
+struct BenchOptions
+{
+    string algorithm;
+    string representation;
+    string graph_path;
+    string format;
+    bool symmetrize = false;
+    string generator = "uniform";
+    size_t num_vert = 0;
+    size_t floyd_vertices = 0;
+    uint64_t num_edges = 0;
+    int max_weight = 100;
+    bool directed = false;
+    uint64_t seed = 1;
+    vector<int> threads;
+    string scaling;
+    int warmup = 1;
+    int trials = 5;
+    string output;
+};
+
+static vector<int> parse_thread_list(const string& text)
+{
+    vector<int> threads;
+    stringstream in(text);
+    for (string item; getline(in, item, ',');) {
+        int count = stoi(item);
+        if (count < 1)
+            throw invalid_argument("Thread counts must be positive");
+        threads.push_back(count);
+    }
+    if (threads.empty())
+        throw invalid_argument("No thread counts given");
+    return threads;
+}
+
+static BenchOptions parse_options(int argc, char** argv)
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc)
+                throw invalid_argument(flag + " needs a value");
+            return argv[++i];
+        };
+
+        if (flag == "--algorithm") options.algorithm = value();
+        else if (flag == "--representation") options.representation = value();
+        else if (flag == "--graph") options.graph_path = value();
+        else if (flag == "--format") options.format = value();
+        else if (flag == "--symmetrize") options.symmetrize = true;
+        else if (flag == "--generator") options.generator = value();
+        else if (flag == "--vertices") options.num_vert = stoull(value());
+        else if (flag == "--floyd-vertices") options.floyd_vertices = stoull(value());
+        else if (flag == "--edges") options.num_edges = stoull(value());
+        else if (flag == "--max-weight") options.max_weight = stoi(value());
+        else if (flag == "--directed") options.directed = true;
+        else if (flag == "--seed") options.seed = stoull(value());
+        else if (flag == "--threads") options.threads = parse_thread_list(value());
+        else if (flag == "--warmup") options.warmup = stoi(value());
+        else if (flag == "--trials") options.trials = stoi(value());
+        else if (flag == "--output") options.output = value();
+        else if (flag == "--scaling") options.scaling = value();
+        else throw invalid_argument("Unknown option " + flag);
+    }
+
+    if (!options.scaling.empty() && options.scaling != "strong" && options.scaling != "weak")
+        throw invalid_argument("--scaling must be strong or weak");
+    if (options.algorithm.empty() && options.scaling.empty())
+        throw invalid_argument("--algorithm is required");
+    if (options.graph_path.empty() && options.num_vert == 0)
+        throw invalid_argument("Either --graph or --vertices is required");
+    if (options.scaling == "weak" && !options.graph_path.empty())
+        throw invalid_argument("Weak scaling generates its graphs; use --generator and --vertices");
+    if (options.warmup < 0 || options.trials < 1)
+        throw invalid_argument("--warmup must be >= 0 and --trials >= 1");
+    return options;
+}
+
+static bool csv_output(const string& path)
+{
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+}
+
+// the graph named by --graph, or generated from the generator options
+static StoredGraph load_bench_graph(const BenchOptions& options, json& graph_json)
+{
+    StoredGraph stored;
+    if (!options.graph_path.empty()) {
+        stored = load_graph(options.graph_path, options.format, options.symmetrize);
+        graph_json["file"] = options.graph_path;
+        return stored;
+    }
+
+    GraphCSR csr = generate_graph_csr(graph_generator(options.generator), options.num_vert, options.max_weight,
+                                      options.num_edges, options.directed, options.seed);
+    stored.csr = make_shared<const GraphCSR>(move(csr));
+    graph_json = { {"generator", options.generator}, {"seed", options.seed}, {"directed", options.directed} };
+    return stored;
+}
+
+static void run_scaling(const BenchOptions& options)
+{
+    vector<string> algorithms;
+    stringstream names(options.algorithm);
+    for (string name; getline(names, name, ',');)
+        algorithms.push_back(name);
+    if (algorithms.empty())
+        for (const BenchAlgorithm& algorithm : bench_algorithms())
+            algorithms.push_back(algorithm.name);
+
+    json graph_json;
+    vector<ScalingCurve> curves;
+    if (options.scaling == "strong") {
+        curves = strong_scaling(load_bench_graph(options, graph_json), algorithms, options.threads, options.warmup,
+                                options.trials);
+    } else {
+        WeakScalingGraph base;
+        base.generator = graph_generator(options.generator);
+        base.num_vert = options.num_vert;
+        base.floyd_num_vert = options.floyd_vertices;
+        base.num_edges = options.num_edges;
+        base.max_weight = options.max_weight;
+        base.directed = options.directed;
+        base.seed = options.seed;
+        graph_json = { {"generator", options.generator}, {"seed", options.seed}, {"directed", options.directed},
+                       {"base_num_vert", options.num_vert}, {"base_num_edges", options.num_edges} };
+        curves = weak_scaling(base, algorithms, options.threads, options.warmup, options.trials);
+    }
+
+    cout << options.scaling << " scaling, " << options.warmup << " warmup + " << options.trials << " trials\n";
+    cout << setw(16) << "algorithm" << setw(8) << "threads" << setw(12) << "vertices" << setw(12) << "edges"
+         << setw(12) << "median ms" << setw(10) << "speedup" << setw(12) << "efficiency" << setw(12) << "karp-flatt"
+         << "\n";
+    for (const ScalingCurve& curve : curves) {
+        for (const ScalingPoint& point : curve.points) {
+            cout << setw(16) << curve.algorithm << setw(8) << point.effective_threads << setw(12) << point.num_vert
+                 << setw(12) << point.num_edges << fixed << setprecision(3) << setw(12) << point.kernel.median_ms
+                 << setprecision(2) << setw(10) << point.speedup << setw(12) << point.efficiency << setprecision(3)
+                 << setw(12) << point.karp_flatt << "\n";
+        }
+    }
+
+    if (options.output.empty())
+        return;
+    ofstream out(options.output);
+    if (!out)
+        throw runtime_error("Cannot write '" + options.output + "'");
+
+    if (csv_output(options.output)) {
+        out << "mode,algorithm,threads,effective_threads,num_vert,num_edges,trials,median_ms,median_low_ms,"
+               "median_high_ms,speedup,efficiency,karp_flatt\n";
+        for (const ScalingCurve& curve : curves) {
+            for (const ScalingPoint& p : curve.points) {
+                out << options.scaling << ',' << curve.algorithm << ',' << p.threads << ',' << p.effective_threads
+                    << ',' << p.num_vert << ',' << p.num_edges << ',' << options.trials << ',' << p.kernel.median_ms
+                    << ',' << p.kernel.median_low_ms << ',' << p.kernel.median_high_ms << ',' << p.speedup << ','
+                    << p.efficiency << ',' << p.karp_flatt << '\n';
+            }
+        }
+    } else {
+        json report = { {"mode", options.scaling},
+                        {"graph", graph_json},
+                        {"warmup", options.warmup},
+                        {"trials", options.trials},
+                        {"compute_threads", thread_budget().capacity()},
+                        {"curves", scaling_json(curves)} };
+        out << report.dump(2) << "\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n"
+             << "usage: " << argv[0] << " --algorithm <name> [--representation matrix|csr|list]\n"
+             << "         (--graph <file> [--format snap|mtx|dimacs] [--symmetrize] |\n"
+             << "          --generator <family> --vertices <n> [--edges <m>] [--max-weight <w>] [--directed] [--seed <s>])\n"
+             << "         [--threads 1,2,4] [--warmup 1] [--trials 5] [--output <file.json|file.csv>]\n"
+             << "       " << argv[0] << " --scaling strong|weak [--algorithm <name,name,...>] <graph as above>\n"
+             << "         [--floyd-vertices <n>] ...\n";
+        return 2;
+    }
+
+    try {
+        if (!options.scaling.empty()) {
+            run_scaling(options);
+            return 0;
+        }
+
+        const BenchAlgorithm* algorithm = &bench_algorithm(options.algorithm);
+
+        string representation = options.representation.empty() ? algorithm->representations[0] : options.representation;
+        if (find(algorithm->representations.begin(), algorithm->representations.end(), representation) ==
+            algorithm->representations.end())
+            throw invalid_argument(options.algorithm + " does not run on '" + representation + "'");
+
+        json graph_json;
+        BenchGraph graph = bench_graph(load_bench_graph(options, graph_json), representation);
+        graph_json["num_vert"] = graph.num_vert;
+        graph_json["num_edges"] = graph.num_edges;
+
+        auto run = bench_runner(*algorithm, representation, graph);
+        int capacity = thread_budget().capacity();
+        vector<int> sweep{ 1 };
+        if (algorithm->parallel)
+            sweep = options.threads.empty() ? scaling_thread_counts(capacity) : options.threads;
+
+        json results = json::array();
+        cout << options.algorithm << " on " << representation << ": " << graph.num_vert << " vertices, "
+             << graph.num_edges << " edges, " << options.warmup << " warmup + " << options.trials << " trials\n";
+        cout << setw(8) << "threads" << setw(12) << "min ms" << setw(12) << "median ms" << setw(12) << "p95 ms"
+             << setw(14) << (algorithm->edge_based ? "GTEPS" : "ops/s") << setw(12) << "peak MB" << "\n";
+
+        for (int threads : sweep) {
+            vector<double> times_ms;
+            TimingSummary summary = time_runs(run, threads, options.warmup, options.trials, &times_ms);
+            double seconds = summary.median_ms / 1000.0;
+            double work = algorithm->edge_based ? static_cast<double>(graph.num_edges)
+                                                : static_cast<double>(graph.num_vert) * graph.num_vert * graph.num_vert;
+            double rate = seconds > 0 ? (algorithm->edge_based ? work / seconds / 1e9 : work / seconds) : 0.0;
+            size_t rss = peak_rss_bytes();
+
+            cout << setw(8) << threads << fixed << setprecision(3) << setw(12) << summary.min_ms << setw(12)
+                 << summary.median_ms << setw(12) << summary.p95_ms << setw(14) << setprecision(algorithm->edge_based ? 4 : 0)
+                 << rate << setw(12) << setprecision(1) << rss / 1048576.0 << "\n";
+
+            results.push_back({ {"threads", threads},
+                                {"effective_threads", algorithm->parallel ? thread_budget().team_size(threads) : 1},
+                                {"min_ms", summary.min_ms},
+                                {"median_ms", summary.median_ms},
+                                {"median_low_ms", summary.median_low_ms},
+                                {"median_high_ms", summary.median_high_ms},
+                                {"p95_ms", summary.p95_ms},
+                                {"mean_ms", summary.mean_ms},
+                                {"stddev_ms", summary.stddev_ms},
+                                {"rate", rate},
+                                {"rate_unit", algorithm->edge_based ? "GTEPS" : "ops/s"},
+                                {"peak_rss_bytes", rss},
+                                {"times_ms", times_ms} });
+        }
+
+        if (!options.output.empty()) {
+            ofstream out(options.output);
+            if (!out)
+                throw runtime_error("Cannot write '" + options.output + "'");
+
+            if (csv_output(options.output)) {
+                out << "algorithm,representation,num_vert,num_edges,threads,effective_threads,trials,"
+                       "min_ms,median_ms,median_low_ms,median_high_ms,p95_ms,mean_ms,stddev_ms,rate,rate_unit,peak_rss_bytes\n";
+                for (const json& r : results) {
+                    out << options.algorithm << ',' << representation << ',' << graph.num_vert << ',' << graph.num_edges
+                        << ',' << r["threads"] << ',' << r["effective_threads"] << ',' << options.trials << ','
+                        << r["min_ms"] << ',' << r["median_ms"] << ',' << r["median_low_ms"] << ','
+                        << r["median_high_ms"] << ',' << r["p95_ms"] << ',' << r["mean_ms"] << ','
+                        << r["stddev_ms"] << ',' << r["rate"] << ',' << r["rate_unit"].get<string>() << ','
+                        << r["peak_rss_bytes"] << '\n';
+                }
+            } else {
+                json report = { {"algorithm", options.algorithm},
+                                {"representation", representation},
+                                {"graph", graph_json},
+                                {"warmup", options.warmup},
+                                {"trials", options.trials},
+                                {"compute_threads", capacity},
+                                {"results", results} };
+                out << report.dump(2) << "\n";
+            }
+        }
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
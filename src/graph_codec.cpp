@@ -0,0 +1,185 @@
+#include "graph_codec.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+using namespace std;
+
+static_assert(sizeof(int) == sizeof(int32_t), "blob weights are stored as int");
+
+static const char MATRIX_MAGIC[4] = { 'G', 'M', 'A', 'T' };
+static const char CSR_MAGIC[4] = { 'G', 'C', 'S', 'R' };
+
+static bool host_little_endian()
+{
+    const uint16_t probe = 1;
+    uint8_t first;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// copies count values to/from little-endian bytes; a plain memcpy on little-endian hosts
+template <typename T>
+static void write_le(uint8_t* out, const T* values, size_t count)
+{
+    if (host_little_endian()) {
+        memcpy(out, values, count * sizeof(T));
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        auto v = static_cast<typename make_unsigned<T>::type>(values[i]);
+        for (size_t b = 0; b < sizeof(T); b++)
+            *out++ = static_cast<uint8_t>(v >> (8 * b));
+    }
+}
+
+template <typename T>
+static void read_le(const uint8_t* in, T* values, size_t count)
+{
+    if (host_little_endian()) {
+        memcpy(values, in, count * sizeof(T));
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        typename make_unsigned<T>::type v = 0;
+        for (size_t b = 0; b < sizeof(T); b++)
+            v |= static_cast<typename make_unsigned<T>::type>(*in++) << (8 * b);
+        values[i] = static_cast<T>(v);
+    }
+}
+
+// bounds-checked cursor over an incoming blob
+struct BlobReader
+{
+    const uint8_t* pos;
+    const uint8_t* end;
+
+    template <typename T>
+    void read(T* values, size_t count)
+    {
+        if (count > static_cast<size_t>(end - pos) / sizeof(T))
+            throw invalid_argument("Truncated graph blob");
+        read_le(pos, values, count);
+        pos += count * sizeof(T);
+    }
+
+    template <typename T>
+    T read()
+    {
+        T value;
+        read(&value, 1);
+        return value;
+    }
+
+    void expect_magic(const char* magic)
+    {
+        if (end - pos < 4 || memcmp(pos, magic, 4) != 0)
+            throw invalid_argument("Not a graph blob (bad magic)");
+        pos += 4;
+    }
+};
+
+vector<uint8_t> encode_matrix_blob(const GraphMatrix& graph)
+{
+    const size_t n = graph.num_vert;
+    vector<uint8_t> blob(4 + sizeof(uint64_t) + n * n * sizeof(int32_t));
+    uint8_t* out = blob.data();
+
+    memcpy(out, MATRIX_MAGIC, 4);
+    uint64_t num_vert = n;
+    write_le(out + 4, &num_vert, 1);
+    out += 4 + sizeof(uint64_t);
+
+    vector<int32_t> row_out(n);
+    for (size_t i = 0; i < n; i++) {
+        const int* row = graph.weight_matrix[i];
+        for (size_t j = 0; j < n; j++)
+            row_out[j] = row[j] == INF ? BLOB_NO_EDGE : row[j];
+        write_le(out, row_out.data(), n);
+        out += n * sizeof(int32_t);
+    }
+    return blob;
+}
+
+GraphMatrix decode_matrix_blob(const uint8_t* data, size_t size)
+{
+    BlobReader in{ data, data + size };
+    in.expect_magic(MATRIX_MAGIC);
+
+    uint64_t n = in.read<uint64_t>();
+    if (n != 0 && (size - 12) / sizeof(int32_t) / n < n)
+        throw invalid_argument("Truncated graph blob");
+
+    GraphMatrix graph(n);
+    for (size_t i = 0; i < n; i++) {
+        int* row = graph.weight_matrix[i];
+        in.read(row, n);
+        for (size_t j = 0; j < n; j++) {
+            if (row[j] == BLOB_NO_EDGE)
+                row[j] = INF;
+            else if (!weight_in_range(row[j]))
+                throw out_of_range("Edge weight out of range");
+        }
+    }
+    return graph;
+}
+
+vector<uint8_t> encode_csr_blob(const GraphCSR& graph)
+{
+    const size_t n = graph.num_vert;
+    const size_t m = graph.num_edges();
+    vector<uint8_t> blob(4 + 2 * sizeof(uint64_t) + (n + 1) * sizeof(uint64_t) +
+                         m * (sizeof(uint32_t) + sizeof(int32_t)));
+    uint8_t* out = blob.data();
+
+    memcpy(out, CSR_MAGIC, 4);
+    out += 4;
+    uint64_t header[2] = { n, m };
+    write_le(out, header, 2);
+    out += sizeof(header);
+    write_le(out, graph.offsets.data(), n + 1);
+    out += (n + 1) * sizeof(uint64_t);
+    write_le(out, graph.neighbors.data(), m);
+    out += m * sizeof(uint32_t);
+    write_le(out, graph.weights.data(), m);
+    return blob;
+}
+
+GraphCSR decode_csr_blob(const uint8_t* data, size_t size)
+{
+    BlobReader in{ data, data + size };
+    in.expect_magic(CSR_MAGIC);
+
+    uint64_t n = in.read<uint64_t>();
+    uint64_t m = in.read<uint64_t>();
+    // sizes are checked against the blob before anything is allocated
+    size_t remaining = in.end - in.pos;
+    if (n >= remaining / sizeof(uint64_t) || m > remaining / (sizeof(uint32_t) + sizeof(int32_t)))
+        throw invalid_argument("Truncated graph blob");
+    if (!csr_fits_32bit(n))
+        throw length_error("Too many vertices");
+
+    GraphCSR graph(n);
+    in.read(graph.offsets.data(), n + 1);
+    graph.neighbors.resize(m);
+    graph.weights.resize(m);
+    in.read(graph.neighbors.data(), m);
+    in.read(graph.weights.data(), m);
+
+    if (graph.offsets[0] != 0 || graph.offsets[n] != m)
+        throw invalid_argument("Malformed graph blob (offsets)");
+    for (size_t v = 0; v < n; v++) {
+        if (graph.offsets[v] > graph.offsets[v + 1])
+            throw invalid_argument("Malformed graph blob (offsets)");
+    }
+    for (uint32_t to : graph.neighbors) {
+        if (to >= n)
+            throw out_of_range("Vertex index out of range");
+    }
+    for (int weight : graph.weights) {
+        if (!weight_in_range(weight))
+            throw out_of_range("Edge weight out of range");
+    }
+    return graph;
+}
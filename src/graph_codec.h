@@ -0,0 +1,24 @@
+#pragma once
+
+#include "graph.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// raw little-endian graph blobs for the binary wire formats. all integers are little-endian
+// regardless of the host, and every blob starts with a 4-byte magic
+//
+//   matrix: "GMAT", u64 num_vert, then num_vert * num_vert i32 weights row-major
+//           (INT32_MAX marks a missing edge)
+//   csr:    "GCSR", u64 num_vert, u64 num_edges, then (num_vert + 1) u64 offsets,
+//           num_edges u32 neighbors and num_edges i32 weights
+
+const int32_t BLOB_NO_EDGE = INT32_MAX;
+
+std::vector<uint8_t> encode_matrix_blob(const GraphMatrix& graph);
+std::vector<uint8_t> encode_csr_blob(const GraphCSR& graph);
+
+// both throw std::invalid_argument on a truncated or malformed blob
+GraphMatrix decode_matrix_blob(const uint8_t* data, size_t size);
+GraphCSR decode_csr_blob(const uint8_t* data, size_t size);
@@ -0,0 +1,48 @@
+// graph_convert: writes any graph the server accepts into the mmappable graph file format
+//
+//   graph_convert <input> <output> [--matrix] [--format snap|mtx|dimacs] [--symmetrize]
+//
+// the input is detected from its content: a graph file, a raw GMAT / GCSR blob, or a JSON
+// request body carrying "matrix" or "adjList". anything else is read as a SNAP / Matrix Market /
+// DIMACS edge list, by --format or the file extension. --matrix adds the dense matrix section
+#include "graph_file.h"
+#include "graph_loaders.h"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    bool include_matrix = false;
+    bool symmetrize = false;
+    string format;
+    bool usage_error = argc < 3;
+    for (int i = 3; i < argc && !usage_error; i++) {
+        if (strcmp(argv[i], "--matrix") == 0)
+            include_matrix = true;
+        else if (strcmp(argv[i], "--symmetrize") == 0)
+            symmetrize = true;
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+            format = argv[++i];
+        else
+            usage_error = true;
+    }
+    if (usage_error) {
+        cerr << "usage: " << argv[0] << " <input> <output> [--matrix] [--format snap|mtx|dimacs] [--symmetrize]\n";
+        return 2;
+    }
+
+    try {
+        StoredGraph graph = load_graph(argv[1], format, symmetrize);
+        GraphFileInfo info = save_graph_file(argv[2], graph, include_matrix);
+        cout << argv[2] << ": " << info.num_vert << " vertices, " << info.num_edges << " edges"
+             << (info.has_matrix ? ", with matrix" : "") << ", " << info.file_bytes << " bytes\n";
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
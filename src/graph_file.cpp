@@ -0,0 +1,186 @@
+#include "graph_file.h"
+#include "file_mapping.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+
+static const char GRAPH_FILE_MAGIC[8] = { 'P', 'G', 'R', 'A', 'P', 'H', 'F', '\0' };
+static const size_t SECTION_ALIGN = 64;
+
+struct GraphFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t num_vert;
+    uint64_t num_edges;
+    uint64_t offsets_pos;
+    uint64_t neighbors_pos;
+    uint64_t weights_pos;
+    uint64_t matrix_pos;
+    uint64_t matrix_stride;
+    uint8_t reserved[128 - 72];
+};
+
+static_assert(sizeof(GraphFileHeader) == 128, "graph file header must stay 128 bytes");
+static_assert(sizeof(int) == sizeof(int32_t), "matrix section is stored as int");
+
+static bool host_little_endian()
+{
+    const uint16_t probe = 1;
+    uint8_t first;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+static uint64_t align_up(uint64_t pos)
+{
+    return (pos + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+}
+
+static runtime_error io_error(const string& what, const string& path)
+{
+    return runtime_error(what + " '" + path + "': " + strerror(errno));
+}
+
+// writes bytes at pos, zero-padding from the current position
+static void write_section(FILE* file, uint64_t& at, uint64_t pos, const void* data, size_t bytes, const string& path)
+{
+    static const char zeros[SECTION_ALIGN] = {};
+    if (fwrite(zeros, 1, pos - at, file) != pos - at || fwrite(data, 1, bytes, file) != bytes)
+        throw io_error("Cannot write graph file", path);
+    at = pos + bytes;
+}
+
+GraphFileInfo save_graph_file(const string& path, const StoredGraph& graph, bool include_matrix)
+{
+    if (!host_little_endian())
+        throw runtime_error("Graph files can only be written on little-endian hosts");
+
+    auto csr = stored_csr(graph);
+    auto matrix = include_matrix ? stored_matrix(graph) : nullptr;
+    if (!csr)
+        throw invalid_argument("No graph to save");
+
+    const uint64_t n = csr->num_vert;
+    const uint64_t m = csr->num_edges();
+
+    GraphFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+    header.version = GRAPH_FILE_VERSION;
+    header.flags = matrix ? GRAPH_FILE_MATRIX : 0;
+    header.num_vert = n;
+    header.num_edges = m;
+    header.offsets_pos = align_up(sizeof(header));
+    header.neighbors_pos = align_up(header.offsets_pos + (n + 1) * sizeof(uint64_t));
+    header.weights_pos = align_up(header.neighbors_pos + m * sizeof(uint32_t));
+    uint64_t end = header.weights_pos + m * sizeof(int32_t);
+    if (matrix) {
+        header.matrix_stride = matrix->weight_matrix.stride();
+        header.matrix_pos = align_up(end);
+        end = header.matrix_pos + n * header.matrix_stride * sizeof(int32_t);
+    }
+
+    // written beside the target and renamed over it, so graphs mapped from an older
+    // version of the file keep their pages
+    const string tmp_path = path + ".tmp";
+    unique_ptr<FILE, int (*)(FILE*)> file(fopen(tmp_path.c_str(), "wb"), fclose);
+    if (!file)
+        throw io_error("Cannot create graph file", tmp_path);
+
+    uint64_t at = 0;
+    write_section(file.get(), at, 0, &header, sizeof(header), path);
+    write_section(file.get(), at, header.offsets_pos, csr->offsets.data(), (n + 1) * sizeof(uint64_t), path);
+    write_section(file.get(), at, header.neighbors_pos, csr->neighbors.data(), m * sizeof(uint32_t), path);
+    write_section(file.get(), at, header.weights_pos, csr->weights.data(), m * sizeof(int32_t), path);
+    if (matrix) {
+        write_section(file.get(), at, header.matrix_pos, matrix->weight_matrix.data(),
+                      n * header.matrix_stride * sizeof(int32_t), path);
+    }
+
+    if (fclose(file.release()) != 0)
+        throw io_error("Cannot write graph file", tmp_path);
+    if (rename(tmp_path.c_str(), path.c_str()) != 0)
+        throw io_error("Cannot replace graph file", path);
+    return GraphFileInfo{ header.version, n, m, matrix != nullptr, end };
+}
+
+bool is_graph_file(const string& path)
+{
+    char magic[sizeof(GraphFileHeader::magic)] = {};
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    size_t got = fread(magic, 1, sizeof(magic), file);
+    fclose(file);
+    return got == sizeof(magic) && memcmp(magic, GRAPH_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+// a section of count elements at pos must lie inside the file and be aligned for T
+template <typename T>
+static const T* section(const FileMapping& mapping, uint64_t pos, uint64_t count)
+{
+    if (pos % alignof(T) != 0 || pos > mapping.size() || count > (mapping.size() - pos) / sizeof(T))
+        throw invalid_argument("Corrupt graph file (section out of bounds)");
+    return reinterpret_cast<const T*>(mapping.data() + pos);
+}
+
+StoredGraph load_graph_file(const string& path, GraphFileInfo* info)
+{
+    if (!host_little_endian())
+        throw runtime_error("Graph files can only be mapped on little-endian hosts");
+
+    // the mapping is unmapped when the last array viewing it goes away
+    auto mapping = make_shared<const FileMapping>(path);
+    if (mapping->size() < sizeof(GraphFileHeader))
+        throw invalid_argument("Not a graph file: '" + path + "'");
+
+    const GraphFileHeader& header = *section<GraphFileHeader>(*mapping, 0, 1);
+    if (memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) != 0)
+        throw invalid_argument("Not a graph file: '" + path + "'");
+    if (header.version != GRAPH_FILE_VERSION)
+        throw invalid_argument("Unsupported graph file version " + to_string(header.version));
+
+    const uint64_t n = header.num_vert;
+    const uint64_t m = header.num_edges;
+    if (!csr_fits_32bit(n))
+        throw invalid_argument("Corrupt graph file (too many vertices)");
+
+    const uint64_t* offsets = section<uint64_t>(*mapping, header.offsets_pos, n + 1);
+    if (offsets[0] != 0 || offsets[n] != m)
+        throw invalid_argument("Corrupt graph file (offsets)");
+
+    auto csr = make_shared<GraphCSR>();
+    csr->num_vert = n;
+    csr->valid = true;
+    csr->offsets = FlatArray<uint64_t>::view(offsets, n + 1, mapping);
+    csr->neighbors = FlatArray<uint32_t>::view(section<uint32_t>(*mapping, header.neighbors_pos, m), m, mapping);
+    csr->weights = FlatArray<int>::view(section<int>(*mapping, header.weights_pos, m), m, mapping);
+
+    StoredGraph graph;
+    graph.csr = csr;
+    if (header.flags & GRAPH_FILE_MATRIX) {
+        if (header.matrix_stride < n)
+            throw invalid_argument("Corrupt graph file (matrix stride)");
+        uint64_t cells = n == 0 ? 0 : n * header.matrix_stride;
+        if (n != 0 && cells / n != header.matrix_stride)
+            throw invalid_argument("Corrupt graph file (matrix stride)");
+
+        auto matrix = make_shared<GraphMatrix>();
+        matrix->num_vert = n;
+        matrix->valid = true;
+        matrix->weight_matrix = Matrix::view(section<int>(*mapping, header.matrix_pos, cells), n,
+                                             header.matrix_stride, mapping);
+        graph.matrix = matrix;
+    }
+
+    if (info)
+        *info = GraphFileInfo{ header.version, n, m, graph.matrix != nullptr, mapping->size() };
+    return graph;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "graph_store.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// versioned on-disk graph file, laid out to be mmapped and used in place:
+//
+//   header (128 bytes): magic "PGRAPHF\0", u32 version, u32 flags, u64 num_vert, u64 num_edges,
+//                       u64 positions of the offsets, neighbors, weights and matrix sections,
+//                       u64 matrix row stride (in elements)
+//   sections, each starting on a 64-byte boundary:
+//     u64 offsets[num_vert + 1], u32 neighbors[num_edges], i32 weights[num_edges]
+//     and, if GRAPH_FILE_MATRIX is set, i32 matrix[num_vert][stride] with INF = no edge
+//
+// integers are little-endian; files are written and mapped on little-endian hosts only
+
+const uint32_t GRAPH_FILE_VERSION = 1;
+const uint32_t GRAPH_FILE_MATRIX = 1; // flag: dense matrix section present
+
+struct GraphFileInfo
+{
+    uint32_t version;
+    size_t num_vert;
+    size_t num_edges;
+    bool has_matrix;
+    size_t file_bytes;
+};
+
+// writes the CSR sections and, with include_matrix, the dense section; whichever form the graph
+// lacks is derived. throws std::runtime_error on I/O errors
+GraphFileInfo save_graph_file(const std::string& path, const StoredGraph& graph, bool include_matrix);
+
+// maps the file read-only and returns a graph whose arrays view the mapping directly; the
+// mapping stays alive while any array refers to it. only the header and the offsets bounds are
+// checked, so files are trusted. throws std::runtime_error / std::invalid_argument
+StoredGraph load_graph_file(const std::string& path, GraphFileInfo* info = nullptr);
+
+// true when the file starts with the graph file magic; false for missing or short files
+bool is_graph_file(const std::string& path);
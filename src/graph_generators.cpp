@@ -0,0 +1,406 @@
+#include "graph_generators.h"
+#include "philox.h"
+#include "thread_budget.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+// independent Philox streams under one seed; R-MAT takes 16 streams per attempt from RMAT_STREAM on
+enum GeneratorStream : uint64_t { EDGE_STREAM = 1, WEIGHT_STREAM = 2, PERMUTE_STREAM = 3, BA_STREAM = 4, RMAT_STREAM = 16 };
+
+uint64_t random_seed()
+{
+    random_device device;
+    uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device() ^
+                    static_cast<uint64_t>(chrono::steady_clock::now().time_since_epoch().count());
+    return seed ? seed : 1;
+}
+
+// LSD radix sort over the bits that max_value needs. every pass is a stable counting sort with
+// per-thread histograms, so the output is the same for any thread count
+static void radix_sort(vector<uint64_t>& keys, uint64_t max_value)
+{
+    const int RADIX_BITS = 11;
+    const size_t BUCKETS = size_t(1) << RADIX_BITS;
+
+    int key_bits = 64 - __builtin_clzll(max_value | 1);
+    int max_threads = 1;
+#ifdef _OPENMP
+    max_threads = omp_get_max_threads();
+#endif
+    vector<uint64_t> buffer(keys.size());
+    vector<size_t> counts(max_threads * BUCKETS);
+
+    for (int shift = 0; shift < key_bits; shift += RADIX_BITS)
+    {
+        #pragma omp parallel
+        {
+            int thread = 0, threads = 1;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+            threads = omp_get_num_threads();
+#endif
+            size_t first = keys.size() * thread / threads;
+            size_t last = keys.size() * (thread + 1) / threads;
+            size_t* count = counts.data() + thread * BUCKETS;
+
+            fill(count, count + BUCKETS, 0);
+            for (size_t i = first; i < last; i++)
+                count[(keys[i] >> shift) & (BUCKETS - 1)]++;
+
+            // bucket-major, thread-minor exclusive scan gives every thread its output slots
+            #pragma omp barrier
+            #pragma omp single
+            {
+                size_t total = 0;
+                for (size_t b = 0; b < BUCKETS; b++) {
+                    for (int t = 0; t < threads; t++) {
+                        size_t c = counts[t * BUCKETS + b];
+                        counts[t * BUCKETS + b] = total;
+                        total += c;
+                    }
+                }
+            }
+
+            for (size_t i = first; i < last; i++)
+                buffer[count[(keys[i] >> shift) & (BUCKETS - 1)]++] = keys[i];
+        }
+        keys.swap(buffer);
+    }
+}
+
+// count distinct values from [0, universe), sorted. draw i of the stream is a pure function of
+// the seed, and each round draws exactly the number still missing, so the result does not depend
+// on the thread count. callers keep count <= universe / 2, where each round at least halves the gap
+static vector<uint64_t> sample_distinct(uint64_t universe, uint64_t count, const Philox4x32& rng)
+{
+    vector<uint64_t> chosen;
+    uint64_t next_draw = 0;
+
+    while (chosen.size() < count) {
+        vector<uint64_t> fresh(count - chosen.size());
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < fresh.size(); i++)
+            fresh[i] = rng.below(universe, next_draw + i, EDGE_STREAM);
+        next_draw += fresh.size();
+        radix_sort(fresh, universe - 1);
+
+        if (chosen.empty()) {
+            chosen.swap(fresh);
+        } else {
+            vector<uint64_t> merged(chosen.size() + fresh.size());
+            merge(chosen.begin(), chosen.end(), fresh.begin(), fresh.end(), merged.begin());
+            chosen.swap(merged);
+        }
+        chosen.erase(unique(chosen.begin(), chosen.end()), chosen.end());
+    }
+    return chosen;
+}
+
+// sorted values of [0, universe) that are not in the sorted, distinct excluded list
+static vector<uint64_t> complement(uint64_t universe, const vector<uint64_t>& excluded)
+{
+    vector<uint64_t> kept(universe - excluded.size());
+
+    // gap g lies between excluded[g - 1] and excluded[g]; its values shift down by g
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (size_t g = 0; g <= excluded.size(); g++)
+    {
+        uint64_t from = g == 0 ? 0 : excluded[g - 1] + 1;
+        uint64_t to = g == excluded.size() ? universe : excluded[g];
+        for (uint64_t value = from; value < to; value++)
+            kept[value - g] = value;
+    }
+    return kept;
+}
+
+// edges are numbered row by row. directed: row u holds the n - 1 targets v != u.
+// undirected: row u holds the pairs (u, v > u)
+static uint64_t row_start(uint64_t u, uint64_t n, bool isDirected)
+{
+    if (isDirected)
+        return u * (n - 1);
+    return static_cast<uint64_t>(static_cast<unsigned __int128>(u) * (2 * n - u - 1) / 2);
+}
+
+static uint64_t row_target(uint64_t u, uint64_t column, bool isDirected)
+{
+    if (isDirected)
+        return column < u ? column : column + 1;
+    return u + 1 + column;
+}
+
+uint64_t max_possible_edges(size_t num_vert, bool isDirected)
+{
+    uint64_t n = num_vert;
+    return n < 2 ? 0 : (isDirected ? n * (n - 1) : n * (n - 1) / 2);
+}
+
+GraphCSR generate_random_graph_csr(size_t num_vert, int max_weight, uint64_t num_edges, bool isDirected,
+                                   uint64_t seed, int num_threads)
+{
+    if (max_weight < 1)
+        throw invalid_argument("max_weight must be at least 1");
+    if (!csr_fits_32bit(num_vert))
+        throw invalid_argument("Too many vertices for a generated graph");
+
+    const uint64_t n = num_vert;
+    const uint64_t possible_edges = max_possible_edges(num_vert, isDirected);
+    if (num_edges > possible_edges)
+        throw invalid_argument("num_edges exceeds the edges a simple graph on num_vert vertices can hold");
+
+    ThreadTeam team(num_threads);
+    Philox4x32 rng(seed);
+
+    // above half density, sample the edges to leave out
+    vector<uint64_t> edges = num_edges <= possible_edges / 2
+        ? sample_distinct(possible_edges, num_edges, rng)
+        : complement(possible_edges, sample_distinct(possible_edges, possible_edges - num_edges, rng));
+
+    // edges are sorted by index, so the edges leaving u are edges[first[u] .. first[u + 1])
+    vector<uint64_t> first(num_vert + 1, edges.size());
+    #pragma omp parallel for schedule(static)
+    for (size_t u = 0; u < num_vert; u++)
+        first[u] = lower_bound(edges.begin(), edges.end(), row_start(u, n, isDirected)) - edges.begin();
+
+    // the weight is drawn from the edge index, so it does not depend on where the edge lands
+    auto weight_of = [&](uint64_t index) { return 1 + static_cast<int>(rng.below(max_weight, index, WEIGHT_STREAM)); };
+
+    GraphCSR csr(num_vert);
+    if (isDirected) {
+        // sorted edge e is exactly CSR slot e
+        copy(first.begin(), first.end(), csr.offsets.begin());
+        csr.neighbors.resize(edges.size());
+        csr.weights.resize(edges.size());
+        uint32_t* neighbors = csr.neighbors.data();
+        int* weights = csr.weights.data();
+
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (size_t u = 0; u < num_vert; u++)
+        {
+            uint64_t start = row_start(u, n, true);
+            for (uint64_t e = first[u]; e < first[u + 1]; e++) {
+                neighbors[e] = static_cast<uint32_t>(row_target(u, edges[e] - start, true));
+                weights[e] = weight_of(edges[e]);
+            }
+        }
+        return csr;
+    }
+
+    // undirected row v: neighbors u < v (edges stored under u), then the sorted edges leaving v.
+    // the mirrored edges are keyed v * n + u and radix sorted, which groups them by row in order
+    vector<uint64_t> mirrored(edges.size());
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (size_t u = 0; u < num_vert; u++)
+    {
+        uint64_t start = row_start(u, n, false);
+        for (uint64_t e = first[u]; e < first[u + 1]; e++)
+            mirrored[e] = row_target(u, edges[e] - start, false) * n + u;
+    }
+    radix_sort(mirrored, n * n - 1);
+
+    vector<uint64_t> mirrored_first(num_vert + 1, edges.size());
+    #pragma omp parallel for schedule(static)
+    for (size_t v = 0; v < num_vert; v++)
+        mirrored_first[v] = lower_bound(mirrored.begin(), mirrored.end(), v * n) - mirrored.begin();
+
+    for (size_t v = 0; v <= num_vert; v++)
+        csr.offsets[v] = mirrored_first[v] + first[v];
+    csr.neighbors.resize(2 * edges.size());
+    csr.weights.resize(2 * edges.size());
+    uint32_t* neighbors = csr.neighbors.data();
+    int* weights = csr.weights.data();
+    const uint64_t* offsets = csr.offsets.data();
+
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (size_t v = 0; v < num_vert; v++)
+    {
+        uint64_t slot = offsets[v];
+        for (uint64_t i = mirrored_first[v]; i < mirrored_first[v + 1]; i++, slot++) {
+            uint64_t u = mirrored[i] % n;
+            neighbors[slot] = static_cast<uint32_t>(u);
+            weights[slot] = weight_of(row_start(u, n, false) + (v - u - 1));
+        }
+
+        uint64_t start = row_start(v, n, false);
+        for (uint64_t e = first[v]; e < first[v + 1]; e++, slot++) {
+            neighbors[slot] = static_cast<uint32_t>(row_target(v, edges[e] - start, false));
+            weights[slot] = weight_of(edges[e]);
+        }
+    }
+    return csr;
+}
+
+GraphGenerator graph_generator(const string& name)
+{
+    if (name == "uniform") return GraphGenerator::Uniform;
+    if (name == "rmat") return GraphGenerator::Rmat;
+    if (name == "ba") return GraphGenerator::BarabasiAlbert;
+    if (name == "grid") return GraphGenerator::Grid;
+    if (name == "chain") return GraphGenerator::Chain;
+    throw invalid_argument("Unknown generator '" + name + "'");
+}
+
+// R-MAT quadrant probabilities used by Graph500
+const double RMAT_A = 0.57, RMAT_B = 0.19, RMAT_C = 0.19;
+
+// edge i of an R-MAT graph over 2^scale vertices: every level picks a quadrant of the adjacency
+// matrix, one 32-bit Philox word per level. draws with an endpoint >= n are redone on a fresh stream
+static void rmat_edge(uint64_t i, int scale, uint64_t n, const Philox4x32& rng, uint64_t& from, uint64_t& to)
+{
+    for (uint64_t attempt = 0;; attempt++) {
+        from = to = 0;
+        uint32_t words[4];
+        for (int level = 0; level < scale; level++) {
+            if (level % 4 == 0)
+                rng.block(i, RMAT_STREAM + attempt * 16 + level / 4, words);
+            double r = words[level % 4] * 0x1.0p-32;
+            uint64_t bit = uint64_t(1) << level;
+            if (r < RMAT_A) continue;
+            if (r < RMAT_A + RMAT_B) to |= bit;
+            else if (r < RMAT_A + RMAT_B + RMAT_C) from |= bit;
+            else { from |= bit; to |= bit; }
+        }
+        if (from < n && to < n)
+            return;
+    }
+}
+
+// target of Barabasi-Albert edge i, whose source is vertex 1 + i / m. all edge endpoints form one
+// list [s0, t0, s1, t1, ...] and t_i copies a uniform earlier entry, which picks a vertex with
+// probability proportional to its degree. copying another target follows that edge back, so every
+// edge resolves independently (Sanders & Schulz, "Scalable generation of scale-free graphs")
+static uint64_t ba_target(uint64_t i, uint64_t m, const Philox4x32& rng)
+{
+    while (i > 0) {
+        uint64_t r = rng.below(2 * i, i, BA_STREAM);
+        if (r % 2 == 0)
+            return 1 + (r / 2) / m;
+        i = (r - 1) / 2;
+    }
+    return 0;
+}
+
+// edges of every non-uniform family as keys from * n + to; self loops become n * n so they sort last
+static vector<uint64_t> family_edge_keys(GraphGenerator generator, uint64_t n, uint64_t num_edges,
+                                         bool isDirected, const Philox4x32& rng)
+{
+    const uint64_t self_loop = n * n;
+    vector<uint64_t> keys;
+    auto key = [&](uint64_t from, uint64_t to) { return from == to ? self_loop : from * n + to; };
+
+    if (generator == GraphGenerator::Rmat) {
+        int scale = 0;
+        while ((uint64_t(1) << scale) < n) scale++;
+
+        // Graph500 relabels vertices so the high-degree ones are not all at small ids
+        vector<uint32_t> label(n);
+        for (uint64_t v = 0; v < n; v++) label[v] = static_cast<uint32_t>(v);
+        for (uint64_t v = n; v > 1; v--)
+            swap(label[v - 1], label[rng.below(v, v, PERMUTE_STREAM)]);
+
+        keys.resize(num_edges);
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < num_edges; i++)
+        {
+            uint64_t from, to;
+            rmat_edge(i, scale, n, rng, from, to);
+            keys[i] = key(label[from], label[to]);
+        }
+    } else if (generator == GraphGenerator::BarabasiAlbert) {
+        uint64_t m = max<uint64_t>(1, num_edges / (n - 1));
+        keys.resize((n - 1) * m);
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < keys.size(); i++)
+            keys[i] = key(1 + i / m, ba_target(i, m, rng));
+    } else if (generator == GraphGenerator::Grid) {
+        uint64_t rows = 1;
+        while ((rows + 1) * (rows + 1) <= n) rows++;
+        uint64_t cols = (n + rows - 1) / rows;
+
+        // every vertex owns the edges to its right and lower neighbors
+        keys.assign(2 * n, self_loop);
+        #pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < n; v++)
+        {
+            if ((v + 1) % cols != 0 && v + 1 < n) keys[2 * v] = key(v, v + 1);
+            if (v + cols < n) keys[2 * v + 1] = key(v, v + cols);
+        }
+    } else {
+        keys.resize(n - 1);
+        #pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < n - 1; v++)
+            keys[v] = key(v, v + 1);
+    }
+
+    if (!isDirected) {
+        size_t count = keys.size();
+        keys.resize(2 * count);
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < count; i++)
+            keys[count + i] = keys[i] == self_loop ? self_loop : (keys[i] % n) * n + keys[i] / n;
+    }
+    return keys;
+}
+
+GraphCSR generate_graph_csr(GraphGenerator generator, size_t num_vert, int max_weight, uint64_t num_edges,
+                            bool isDirected, uint64_t seed, int num_threads)
+{
+    // before taking a team here, which would leave the inner call waiting on it
+    if (generator == GraphGenerator::Uniform)
+        return generate_random_graph_csr(num_vert, max_weight, num_edges, isDirected, seed, num_threads);
+
+    if (max_weight < 1)
+        throw invalid_argument("max_weight must be at least 1");
+    if (!csr_fits_32bit(num_vert))
+        throw invalid_argument("Too many vertices for a generated graph");
+    if (num_vert < 2)
+        return GraphCSR(num_vert);
+    // rmat draws and ba attachments are allocated up front, one key per requested edge
+    bool sized_by_edges = generator == GraphGenerator::Rmat || generator == GraphGenerator::BarabasiAlbert;
+    if (sized_by_edges && num_edges > max_possible_edges(num_vert, isDirected))
+        throw invalid_argument("num_edges exceeds the edges a simple graph on num_vert vertices can hold");
+
+    ThreadTeam team(num_threads);
+    Philox4x32 rng(seed);
+    const uint64_t n = num_vert;
+
+    // sorting the keys orders the edges by (from, to); unique() drops repeated draws
+    vector<uint64_t> keys = family_edge_keys(generator, n, num_edges, isDirected, rng);
+    radix_sort(keys, n * n);
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    if (!keys.empty() && keys.back() == n * n)
+        keys.pop_back();
+
+    GraphCSR csr(num_vert);
+    csr.neighbors.resize(keys.size());
+    csr.weights.resize(keys.size());
+    uint64_t* offsets = csr.offsets.data();
+    uint32_t* neighbors = csr.neighbors.data();
+    int* weights = csr.weights.data();
+
+    #pragma omp parallel for schedule(static)
+    for (size_t v = 0; v < num_vert; v++)
+        offsets[v] = lower_bound(keys.begin(), keys.end(), v * n) - keys.begin();
+    offsets[num_vert] = keys.size();
+
+    // both directions of an undirected edge draw their weight from the same key
+    #pragma omp parallel for schedule(static)
+    for (size_t e = 0; e < keys.size(); e++)
+    {
+        uint64_t from = keys[e] / n, to = keys[e] % n;
+        uint64_t weight_key = isDirected || from < to ? keys[e] : to * n + from;
+        neighbors[e] = static_cast<uint32_t>(to);
+        weights[e] = 1 + static_cast<int>(rng.below(max_weight, weight_key, WEIGHT_STREAM));
+    }
+    return csr;
+}
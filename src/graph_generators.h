@@ -0,0 +1,39 @@
+#pragma once
+
+#include "graph.h"
+
+#include <cstdint>
+#include <string>
+
+// a fresh seed for callers that did not ask for one (never 0)
+uint64_t random_seed();
+
+// uniform random graph with exactly num_edges distinct edges (pairs u < v when undirected, each
+// stored in both directions) and weights in [1, max_weight]. edges are drawn in parallel from a
+// Philox stream keyed by seed and deduplicated by sorting, with no rejection loop: above half
+// density the missing edges are sampled instead. the same seed gives the same graph for any
+// num_threads. throws std::invalid_argument when num_edges exceeds max_possible_edges, for
+// max_weight < 1 or for num_vert above 32-bit ids
+GraphCSR generate_random_graph_csr(size_t num_vert, int max_weight, uint64_t num_edges, bool isDirected,
+                                   uint64_t seed, int num_threads = 0);
+
+// edges of a simple graph: n(n - 1), or n(n - 1) / 2 undirected edges
+uint64_t max_possible_edges(size_t num_vert, bool isDirected);
+
+// graph families for benchmarks, from easiest to hardest for label propagation:
+//   uniform: generate_random_graph_csr, exactly num_edges edges
+//   rmat:    R-MAT / Graph500 Kronecker (a, b, c = 0.57, 0.19, 0.19) with num_edges draws and
+//            shuffled vertex labels; power-law degrees, duplicates and self loops are dropped
+//   ba:      Barabasi-Albert preferential attachment, num_edges / (num_vert - 1) edges per new vertex
+//   grid:    near-square 2D grid, the shape of road networks (num_edges is ignored)
+//   chain:   a path 0 - 1 - ... - n-1, diameter n - 1 (num_edges is ignored)
+enum class GraphGenerator { Uniform, Rmat, BarabasiAlbert, Grid, Chain };
+
+// "uniform", "rmat", "ba", "grid" or "chain"; throws std::invalid_argument otherwise
+GraphGenerator graph_generator(const std::string& name);
+
+// any family above, reproducible from the seed for any num_threads. undirected graphs store every
+// edge in both directions with the same weight; rows are sorted by neighbor. rmat and ba throw
+// std::invalid_argument when num_edges exceeds the possible edges, before allocating anything
+GraphCSR generate_graph_csr(GraphGenerator generator, size_t num_vert, int max_weight, uint64_t num_edges,
+                            bool isDirected, uint64_t seed, int num_threads = 0);
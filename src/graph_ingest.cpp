@@ -0,0 +1,330 @@
+#include "graph_ingest.h"
+#include "graph_codec.h"
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using json = nlohmann::json;
+using namespace std;
+
+// SAX events for one request. top-level options are built into a small DOM; the graph
+// field is consumed as it streams by
+class GraphRequestSax : public json::json_sax_t
+{
+public:
+    explicit GraphRequestSax(json& options) : options(options) {}
+
+    bool null() override
+    {
+        if (field == Matrix) return matrix_cell(INF);
+        return scalar(json(nullptr));
+    }
+
+    bool boolean(bool val) override { return scalar(json(val)); }
+
+    bool number_integer(number_integer_t val) override
+    {
+        if (field == Matrix) return matrix_cell(to_int(val));
+        if (field == AdjList) return edge_field(val);
+        return scalar(json(val));
+    }
+
+    bool number_unsigned(number_unsigned_t val) override
+    {
+        if (field == Matrix) return matrix_cell(to_int(val));
+        if (field == AdjList) return edge_field(val);
+        return scalar(json(val));
+    }
+
+    bool number_float(number_float_t val, const string_t&) override
+    {
+        if (field == Matrix) return matrix_cell(to_int(to_int64(val)));
+        if (field == AdjList) return edge_field(to_int64(val));
+        return scalar(json(val));
+    }
+
+    bool string(string_t& val) override { return scalar(json(move(val))); }
+
+    bool binary(binary_t& val) override
+    {
+        if (field == Matrix && depth == 1) {
+            matrix = make_shared<GraphMatrix>(decode_matrix_blob(val.data(), val.size()));
+            return end_field();
+        }
+        if (field == Csr && depth == 1) {
+            csr = make_shared<GraphCSR>(decode_csr_blob(val.data(), val.size()));
+            return end_field();
+        }
+        return scalar(json::binary(move(val)));
+    }
+
+    bool start_object(size_t) override
+    {
+        depth++;
+        if (depth == 1)
+            return true;
+        if (field == AdjList) {
+            if (depth != 4)
+                throw invalid_argument("adjList entries must be {\"to\", \"weight\"} objects");
+            edge_to = edge_weight = -1;
+            edge_has_weight = false;
+            return true;
+        }
+        if (field != Option)
+            throw invalid_argument("Unexpected object in graph data");
+        return open(json::object());
+    }
+
+    bool key(string_t& val) override
+    {
+        if (depth == 1) {
+            begin_field(val);
+        } else if (field == AdjList) {
+            edge_key = val;
+        } else {
+            dom_key = move(val);
+        }
+        return true;
+    }
+
+    bool end_object() override
+    {
+        depth--;
+        if (depth == 0)
+            return true;
+        if (field == AdjList) {
+            if (edge_to < 0 || !edge_has_weight)
+                throw invalid_argument("adjList entries need \"to\" and \"weight\"");
+            if (edge_to > UINT32_MAX)
+                throw out_of_range("Vertex index out of range");
+            csr->neighbors.push_back(static_cast<uint32_t>(edge_to));
+            csr->weights.push_back(static_cast<int>(edge_weight));
+            return true;
+        }
+        return close();
+    }
+
+    bool start_array(size_t) override
+    {
+        depth++;
+        if (depth == 1)
+            throw invalid_argument("Request must be a JSON object");
+
+        if (field == Matrix) {
+            if (depth == 2) {
+                rows = 0;
+            } else if (depth == 3) {
+                row_pos = 0;
+            } else {
+                throw invalid_argument("Matrix rows must hold numbers or null");
+            }
+            return true;
+        }
+        if (field == AdjList) {
+            if (depth == 2) {
+                csr = make_shared<GraphCSR>(0);
+            } else if (depth != 3) {
+                throw invalid_argument("adjList entries must be {\"to\", \"weight\"} objects");
+            }
+            return true;
+        }
+        if (field == Csr)
+            throw invalid_argument("csr must be a binary graph blob");
+        return open(json::array());
+    }
+
+    bool end_array() override
+    {
+        depth--;
+        if (field == Matrix) {
+            if (depth == 2)
+                return end_matrix_row();
+            return end_matrix();
+        }
+        if (field == AdjList) {
+            if (depth == 2) {
+                csr->offsets.push_back(csr->neighbors.size());
+                return true;
+            }
+            return end_adjList();
+        }
+        return close();
+    }
+
+    bool parse_error(size_t, const std::string&, const nlohmann::detail::exception& ex) override
+    {
+        throw invalid_argument(ex.what());
+    }
+
+    shared_ptr<GraphMatrix> matrix;
+    shared_ptr<GraphCSR> csr;
+
+private:
+    enum Field { Option, Matrix, AdjList, Csr };
+
+    void begin_field(const std::string& name)
+    {
+        field = Option;
+        if (name == "matrix") field = Matrix;
+        else if (name == "adjList") field = AdjList;
+        else if (name == "csr") field = Csr;
+
+        if (field != Option && (matrix || csr))
+            throw invalid_argument("Only one of matrix, adjList or csr may be given");
+        dom_key = name;
+    }
+
+    bool end_field()
+    {
+        field = Option;
+        return true;
+    }
+
+    // weights must be finite, see weight_in_range
+    template <typename T>
+    static int to_int(T val)
+    {
+        if (val >= static_cast<T>(INF) || !weight_in_range(static_cast<int64_t>(val)))
+            throw out_of_range("Edge weight out of range");
+        return static_cast<int>(val);
+    }
+
+    // truncates toward zero; NaN and values past int64 have no conversion
+    static int64_t to_int64(double val)
+    {
+        if (!(val > -0x1p63 && val < 0x1p63))
+            throw out_of_range("Number out of range");
+        return static_cast<int64_t>(val);
+    }
+
+    // the first row is buffered until its length gives the vertex count; after that every
+    // row is written in place
+    bool matrix_cell(int weight)
+    {
+        if (depth != 3)
+            throw invalid_argument("Matrix rows must hold numbers or null");
+        if (!matrix) {
+            first_row.push_back(weight);
+            return true;
+        }
+        if (row_pos >= matrix->num_vert || rows >= matrix->num_vert)
+            throw invalid_argument("Matrix must be square");
+        matrix->weight_matrix[rows][row_pos++] = weight;
+        return true;
+    }
+
+    bool end_matrix_row()
+    {
+        if (!matrix) {
+            matrix = make_shared<GraphMatrix>(first_row.size());
+            copy(first_row.begin(), first_row.end(), matrix->weight_matrix[0]);
+            row_pos = first_row.size();
+            vector<int>().swap(first_row);
+        }
+        if (row_pos != matrix->num_vert || rows >= matrix->num_vert)
+            throw invalid_argument("Matrix must be square");
+        rows++;
+        return true;
+    }
+
+    bool end_matrix()
+    {
+        if (!matrix)
+            matrix = make_shared<GraphMatrix>(0);
+        if (rows != matrix->num_vert)
+            throw invalid_argument("Matrix must be square");
+        return end_field();
+    }
+
+    bool edge_field(int64_t val)
+    {
+        if (depth != 4)
+            throw invalid_argument("adjList entries must be {\"to\", \"weight\"} objects");
+        if (edge_key == "to") {
+            if (val < 0)
+                throw out_of_range("Vertex index out of range");
+            edge_to = val;
+        } else if (edge_key == "weight") {
+            edge_weight = to_int(val);
+            edge_has_weight = true;
+        }
+        return true;
+    }
+
+    bool end_adjList()
+    {
+        csr->num_vert = csr->offsets.size() - 1;
+        if (!csr_fits_32bit(csr->num_vert))
+            throw length_error("Too many vertices");
+        for (uint32_t to : csr->neighbors) {
+            if (to >= csr->num_vert)
+                throw out_of_range("Vertex index out of range");
+        }
+        return end_field();
+    }
+
+    // option values: scalars land in the current container, containers are pushed
+    bool scalar(json&& val)
+    {
+        if (depth == 0)
+            throw invalid_argument("Request must be a JSON object");
+        if (field != Option)
+            throw invalid_argument("Unexpected value in graph data");
+        if (dom_stack.empty()) {
+            options[dom_key] = move(val);
+        } else if (dom_stack.back()->is_array()) {
+            dom_stack.back()->push_back(move(val));
+        } else {
+            (*dom_stack.back())[dom_key] = move(val);
+        }
+        return true;
+    }
+
+    bool open(json&& container)
+    {
+        json* parent = dom_stack.empty() ? &options : dom_stack.back();
+        json* child;
+        if (dom_stack.empty() || !parent->is_array()) {
+            child = &((*parent)[dom_key] = move(container));
+        } else {
+            parent->push_back(move(container));
+            child = &parent->back();
+        }
+        dom_stack.push_back(child);
+        return true;
+    }
+
+    bool close()
+    {
+        dom_stack.pop_back();
+        return true;
+    }
+
+    json& options;
+    Field field = Option;
+    size_t depth = 0;
+
+    vector<json*> dom_stack;
+    std::string dom_key;
+
+    vector<int> first_row;
+    size_t rows = 0;
+    size_t row_pos = 0;
+
+    std::string edge_key;
+    int64_t edge_to = -1;
+    int64_t edge_weight = 0;
+    bool edge_has_weight = false;
+};
+
+json parse_graph_request(const std::string& body, json::input_format_t format, StoredGraph& graph)
+{
+    json options = json::object();
+    GraphRequestSax sax(options);
+    json::sax_parse(body, &sax, format);
+
+    graph.matrix = sax.matrix;
+    graph.csr = sax.csr;
+    return options;
+}
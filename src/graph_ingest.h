@@ -0,0 +1,13 @@
+#pragma once
+
+#include "graph_store.h"
+#include "json.hpp"
+
+#include <string>
+
+// parses a JSON, CBOR or MessagePack request body with a SAX handler. a top-level "matrix"
+// (rows of numbers, null = no edge), "adjList" (per vertex [{"to", "weight"}, ...]) or binary
+// "matrix" / "csr" blob is written straight into the flat matrix or CSR arrays of graph and
+// left out of the returned options, so large uploads never become a DOM.
+// throws std::invalid_argument (or std::out_of_range for bad vertex ids) on malformed input
+nlohmann::json parse_graph_request(const std::string& body, nlohmann::json::input_format_t format, StoredGraph& graph);
@@ -0,0 +1,390 @@
+#include "graph_loaders.h"
+#include "file_mapping.h"
+#include "graph_codec.h"
+#include "graph_file.h"
+#include "graph_ingest.h"
+#include "thread_budget.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+EdgeListFormat edge_list_format(const string& name_or_path)
+{
+    string ext = name_or_path.substr(name_or_path.find_last_of('.') + 1);
+    transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    if (ext == "snap" || ext == "txt" || ext == "el" || ext == "edges") return EdgeListFormat::Snap;
+    if (ext == "mtx") return EdgeListFormat::MatrixMarket;
+    if (ext == "dimacs" || ext == "gr" || ext == "col") return EdgeListFormat::Dimacs;
+    throw invalid_argument("Unknown edge list format '" + name_or_path + "'");
+}
+
+// cursor over one line of the mapped text; never reads past end
+struct LineParser
+{
+    const char* pos;
+    const char* end;
+
+    void skip_blanks()
+    {
+        while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r'))
+            pos++;
+    }
+
+    bool at_end()
+    {
+        skip_blanks();
+        return pos == end;
+    }
+
+    uint64_t number()
+    {
+        skip_blanks();
+        if (pos == end || *pos < '0' || *pos > '9')
+            throw invalid_argument("Malformed edge line: expected a vertex id");
+        uint64_t value = 0;
+        while (pos < end && *pos >= '0' && *pos <= '9') {
+            if (value > (UINT64_MAX - 9) / 10)
+                throw out_of_range("Vertex id out of range");
+            value = value * 10 + (*pos++ - '0');
+        }
+        return value;
+    }
+
+    // integer or real weight ([-+]digits[.digits][e[-+]digits]), rounded to the nearest int
+    int weight()
+    {
+        skip_blanks();
+        bool negative = pos < end && *pos == '-';
+        if (pos < end && (*pos == '-' || *pos == '+'))
+            pos++;
+
+        double value = 0;
+        bool digits = false;
+        while (pos < end && *pos >= '0' && *pos <= '9') {
+            value = value * 10 + (*pos++ - '0');
+            digits = true;
+        }
+        if (pos < end && *pos == '.') {
+            double scale = 0.1;
+            for (pos++; pos < end && *pos >= '0' && *pos <= '9'; pos++, scale /= 10) {
+                value += (*pos - '0') * scale;
+                digits = true;
+            }
+        }
+        if (!digits)
+            throw invalid_argument("Malformed edge line: expected a weight");
+        if (pos < end && (*pos == 'e' || *pos == 'E')) {
+            pos++;
+            bool negative_exp = pos < end && *pos == '-';
+            if (pos < end && (*pos == '-' || *pos == '+'))
+                pos++;
+            int exponent = 0;
+            while (pos < end && *pos >= '0' && *pos <= '9' && exponent < 1000)
+                exponent = exponent * 10 + (*pos++ - '0');
+            value *= pow(10.0, negative_exp ? -exponent : exponent);
+        }
+
+        value = round(negative ? -value : value);
+        if (value >= INF || value <= -INF)
+            throw out_of_range("Edge weight out of range");
+        return static_cast<int>(value);
+    }
+};
+
+struct ParsedEdge
+{
+    uint32_t from;
+    uint32_t to;
+    int weight;
+};
+
+// what the format header says, and where the edge lines start
+struct EdgeListHeader
+{
+    size_t body_start = 0;
+    size_t num_vert = 0; // 0 = unknown, taken from the largest id
+    int base = 0;        // 1 for 1-based ids
+    bool symmetric = false;
+    bool weighted = true;
+};
+
+static const char* line_end(const char* pos, const char* end)
+{
+    const char* nl = static_cast<const char*>(memchr(pos, '\n', end - pos));
+    return nl ? nl : end;
+}
+
+static EdgeListHeader read_header(const char* data, size_t size, EdgeListFormat format)
+{
+    EdgeListHeader header;
+    const char* end = data + size;
+    const char* pos = data;
+
+    if (format == EdgeListFormat::MatrixMarket) {
+        header.base = 1;
+        const char* eol = line_end(pos, end);
+        string banner(pos, eol);
+        transform(banner.begin(), banner.end(), banner.begin(), ::tolower);
+        if (banner.compare(0, 14, "%%matrixmarket") != 0 || banner.find("coordinate") == string::npos)
+            throw invalid_argument("Only coordinate Matrix Market files are supported");
+        if (banner.find("complex") != string::npos)
+            throw invalid_argument("Complex Matrix Market files are not supported");
+        header.weighted = banner.find("pattern") == string::npos;
+        header.symmetric = banner.find("symmetric") != string::npos || banner.find("hermitian") != string::npos;
+
+        // comments, then "rows cols entries"
+        for (pos = eol + (eol < end); pos < end; pos = eol + (eol < end)) {
+            eol = line_end(pos, end);
+            LineParser line{ pos, eol };
+            if (line.at_end() || *line.pos == '%')
+                continue;
+            uint64_t rows = line.number();
+            uint64_t cols = line.number();
+            header.num_vert = max(rows, cols);
+            if (!csr_fits_32bit(header.num_vert))
+                throw out_of_range("Vertex count out of range");
+            header.body_start = eol + (eol < end) - data;
+            return header;
+        }
+        throw invalid_argument("Matrix Market file has no size line");
+    }
+
+    if (format == EdgeListFormat::Dimacs) {
+        header.base = 1;
+        // the "p" line comes before the first edge line
+        for (const char* eol; pos < end; pos = eol + (eol < end)) {
+            eol = line_end(pos, end);
+            LineParser line{ pos, eol };
+            if (line.at_end())
+                continue;
+            char kind = *line.pos++;
+            if (kind == 'a' || kind == 'e')
+                break;
+            if (kind == 'p') {
+                while (line.pos < eol && (*line.pos == ' ' || *line.pos == '\t'))
+                    line.pos++;
+                while (line.pos < eol && *line.pos != ' ' && *line.pos != '\t')
+                    line.pos++; // problem name: sp, edge, ...
+                header.num_vert = line.number();
+                if (!csr_fits_32bit(header.num_vert))
+                    throw out_of_range("Vertex count out of range");
+            }
+        }
+        header.body_start = pos - data;
+        return header;
+    }
+
+    return header;
+}
+
+// parses the edge lines in [pos, end) into out; begin at a line start. id_bound ends up one past
+// the largest vertex id seen, self loops included
+static void parse_chunk(const char* pos, const char* end, EdgeListFormat format, const EdgeListHeader& header,
+                        vector<ParsedEdge>& out, uint64_t& id_bound)
+{
+    for (const char* eol; pos < end; pos = eol + 1) {
+        eol = line_end(pos, end);
+        LineParser line{ pos, eol };
+        if (line.at_end())
+            continue;
+
+        char first = *line.pos;
+        if (format == EdgeListFormat::Dimacs) {
+            if (first != 'a' && first != 'e')
+                continue; // comments, problem line, anything else
+            line.pos++;
+        } else if (first == '#' || first == '%') {
+            continue;
+        }
+
+        uint64_t from = line.number();
+        uint64_t to = line.number();
+        int weight = 1;
+        if (header.weighted && !line.at_end() && (format != EdgeListFormat::Dimacs || first == 'a'))
+            weight = line.weight();
+
+        if (from < static_cast<uint64_t>(header.base) || to < static_cast<uint64_t>(header.base))
+            throw out_of_range("Vertex id out of range");
+        from -= header.base;
+        to -= header.base;
+        if (from >= UINT32_MAX || to >= UINT32_MAX ||
+            (header.num_vert && (from >= header.num_vert || to >= header.num_vert)))
+            throw out_of_range("Vertex id out of range");
+
+        id_bound = max(id_bound, max(from, to) + 1);
+        if (from != to)
+            out.push_back(ParsedEdge{ static_cast<uint32_t>(from), static_cast<uint32_t>(to), weight });
+    }
+}
+
+GraphCSR load_edge_list(const string& path, EdgeListFormat format, bool symmetrize, int num_threads)
+{
+    ThreadTeam team(num_threads);
+    const size_t num_chunks = team.size();
+
+    FileMapping file(path);
+    const char* data = file.data();
+    const size_t size = file.size();
+    EdgeListHeader header = read_header(data, size, format);
+    symmetrize = symmetrize || header.symmetric;
+
+    // chunk boundaries move forward to the next line start
+    vector<size_t> bounds(num_chunks + 1, size);
+    bounds[0] = header.body_start;
+    for (size_t c = 1; c < num_chunks; c++) {
+        size_t at = max(bounds[0], size * c / num_chunks);
+        if (at > bounds[0] && at < size && data[at - 1] != '\n') {
+            const char* nl = static_cast<const char*>(memchr(data + at, '\n', size - at));
+            at = nl ? nl - data + 1 : size;
+        }
+        bounds[c] = max(at, bounds[c - 1]);
+    }
+
+    // phase 1: every chunk parses into its own edge buffer
+    vector<vector<ParsedEdge> > chunk_edges(num_chunks);
+    vector<uint64_t> chunk_bound(num_chunks, 0);
+    vector<string> errors(num_chunks);
+    vector<char> out_of_range_error(num_chunks, 0);
+    #pragma omp parallel for schedule(static, 1)
+    for (size_t c = 0; c < num_chunks; c++)
+    {
+        try {
+            chunk_edges[c].reserve((bounds[c + 1] - bounds[c]) / 8);
+            parse_chunk(data + bounds[c], data + bounds[c + 1], format, header, chunk_edges[c], chunk_bound[c]);
+        } catch (const out_of_range& e) {
+            errors[c] = e.what();
+            out_of_range_error[c] = 1;
+        } catch (const exception& e) {
+            errors[c] = e.what();
+        }
+    }
+    for (size_t c = 0; c < num_chunks; c++) {
+        if (errors[c].empty()) continue;
+        if (out_of_range_error[c]) throw out_of_range(errors[c]);
+        throw invalid_argument(errors[c]);
+    }
+
+    size_t num_vert = header.num_vert;
+    if (num_vert == 0) {
+        for (size_t c = 0; c < num_chunks; c++)
+            num_vert = max<size_t>(num_vert, chunk_bound[c]);
+    }
+
+    // phase 2: count degrees, scan into offsets
+    GraphCSR csr(num_vert);
+    vector<uint64_t> cursor(num_vert + 1, 0);
+    #pragma omp parallel for schedule(static, 1)
+    for (size_t c = 0; c < num_chunks; c++)
+    {
+        for (const ParsedEdge& e : chunk_edges[c]) {
+            __atomic_fetch_add(&cursor[e.from], 1, __ATOMIC_RELAXED);
+            if (symmetrize)
+                __atomic_fetch_add(&cursor[e.to], 1, __ATOMIC_RELAXED);
+        }
+    }
+    uint64_t total = 0;
+    for (size_t v = 0; v < num_vert; v++) {
+        uint64_t degree = cursor[v];
+        cursor[v] = total;
+        total += degree;
+    }
+
+    // phase 3: scatter (neighbor, weight) pairs packed into one word, then sort each adjacency
+    vector<uint64_t> packed(total);
+    auto pack = [](uint32_t to, int weight) {
+        return (static_cast<uint64_t>(to) << 32) | static_cast<uint32_t>(weight);
+    };
+    vector<uint64_t> starts(cursor.begin(), cursor.end() - 1);
+    #pragma omp parallel for schedule(static, 1)
+    for (size_t c = 0; c < num_chunks; c++)
+    {
+        for (const ParsedEdge& e : chunk_edges[c]) {
+            packed[__atomic_fetch_add(&cursor[e.from], 1, __ATOMIC_RELAXED)] = pack(e.to, e.weight);
+            if (symmetrize)
+                packed[__atomic_fetch_add(&cursor[e.to], 1, __ATOMIC_RELAXED)] = pack(e.from, e.weight);
+        }
+        vector<ParsedEdge>().swap(chunk_edges[c]);
+    }
+
+    // by neighbor, then signed weight, so unique() keeps the lightest of duplicate edges
+    auto less_edge = [](uint64_t a, uint64_t b) {
+        uint32_t na = a >> 32, nb = b >> 32;
+        if (na != nb) return na < nb;
+        return static_cast<int>(static_cast<uint32_t>(a)) < static_cast<int>(static_cast<uint32_t>(b));
+    };
+
+    vector<uint64_t> degree(num_vert);
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (size_t v = 0; v < num_vert; v++)
+    {
+        uint64_t* first = packed.data() + starts[v];
+        uint64_t* last = packed.data() + cursor[v];
+        sort(first, last, less_edge);
+        if (symmetrize) {
+            last = unique(first, last, [](uint64_t a, uint64_t b) { return (a >> 32) == (b >> 32); });
+        }
+        degree[v] = last - first;
+    }
+
+    for (size_t v = 0; v < num_vert; v++)
+        csr.offsets[v + 1] = csr.offsets[v] + degree[v];
+    csr.neighbors.resize(csr.offsets[num_vert]);
+    csr.weights.resize(csr.offsets[num_vert]);
+
+    const uint64_t* offsets = csr.offsets.data();
+    uint32_t* neighbors = csr.neighbors.data();
+    int* weights = csr.weights.data();
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (size_t v = 0; v < num_vert; v++)
+    {
+        uint64_t out = offsets[v];
+        for (uint64_t i = starts[v]; i < starts[v] + degree[v]; i++, out++) {
+            neighbors[out] = static_cast<uint32_t>(packed[i] >> 32);
+            weights[out] = static_cast<int>(static_cast<uint32_t>(packed[i]));
+        }
+    }
+    return csr;
+}
+
+StoredGraph load_graph(const string& path, const string& format, bool symmetrize, int num_threads)
+{
+    if (format.empty() && is_graph_file(path))
+        return load_graph_file(path);
+
+    char magic[4] = {};
+    ifstream(path, ios::binary).read(magic, sizeof(magic));
+    bool blob = memcmp(magic, "GMAT", 4) == 0 || memcmp(magic, "GCSR", 4) == 0;
+
+    StoredGraph graph;
+    if (!format.empty() || (!blob && magic[0] != '{')) {
+        EdgeListFormat edge_format = edge_list_format(format.empty() ? path : format);
+        graph.csr = make_shared<const GraphCSR>(load_edge_list(path, edge_format, symmetrize, num_threads));
+        return graph;
+    }
+
+    ifstream in(path, ios::binary);
+    string body((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(body.data());
+    if (memcmp(magic, "GMAT", 4) == 0) {
+        graph.matrix = make_shared<const GraphMatrix>(decode_matrix_blob(data, body.size()));
+    } else if (memcmp(magic, "GCSR", 4) == 0) {
+        graph.csr = make_shared<const GraphCSR>(decode_csr_blob(data, body.size()));
+    } else {
+        parse_graph_request(body, nlohmann::json::input_format_t::json, graph);
+        if (!graph.matrix && !graph.csr)
+            throw invalid_argument("'" + path + "' holds no \"matrix\" or \"adjList\"");
+    }
+    return graph;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "graph.h"
+#include "graph_store.h"
+
+#include <string>
+
+// text formats public graph datasets ship in
+//   snap:   "u v [weight]" per line, 0-based ids, '#' or '%' comments
+//   mtx:    Matrix Market coordinate, 1-based; pattern/integer/real, general/symmetric
+//   dimacs: "p sp n m" / "p edge n m" header, "a u v w" or "e u v" lines, 1-based, 'c' comments
+enum class EdgeListFormat { Snap, MatrixMarket, Dimacs };
+
+// picks the format from a name ("snap", "mtx", "dimacs") or a file extension
+// (.txt/.el/.edges/.snap, .mtx, .gr/.dimacs/.col); throws std::invalid_argument otherwise
+EdgeListFormat edge_list_format(const std::string& name_or_path);
+
+// maps the file and parses it in parallel chunks, then buckets the edges into CSR with every
+// adjacency sorted by neighbor. symmetrize adds the reverse of every edge and drops duplicate
+// edges (keeping the lightest). self loops are dropped. missing weights are 1, real weights rounded.
+// throws std::invalid_argument on malformed input, std::out_of_range for bad vertex ids
+GraphCSR load_edge_list(const std::string& path, EdgeListFormat format, bool symmetrize = false, int num_threads = 0);
+
+// any graph input by content: a graph file (mapped), a GMAT / GCSR blob, a JSON body with
+// "matrix" / "adjList", or else an edge list in format (a name or, when empty, the path's extension)
+StoredGraph load_graph(const std::string& path, const std::string& format = "", bool symmetrize = false,
+                       int num_threads = 0);
@@ -0,0 +1,177 @@
+#include "graph_store.h"
+#include "thread_budget.h"
+
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace std;
+
+size_t StoredGraph::num_vert() const
+{
+    if (matrix) return matrix->num_vert;
+    if (csr) return csr->num_vert;
+    return 0;
+}
+
+// heap bytes only; sections mapped from a graph file are page cache the kernel can drop
+size_t StoredGraph::memory_bytes() const
+{
+    size_t bytes = 0;
+    if (matrix)
+        bytes += matrix->weight_matrix.owned_bytes();
+    if (csr)
+        bytes += csr->owned_bytes();
+    if (derived) {
+        lock_guard<mutex> guard(derived->lock);
+        if (derived->matrix)
+            bytes += derived->matrix->weight_matrix.owned_bytes();
+        if (derived->csr)
+            bytes += derived->csr->owned_bytes();
+    }
+    return bytes;
+}
+
+static size_t form_bytes(const GraphMatrix& matrix) { return matrix.weight_matrix.owned_bytes(); }
+static size_t form_bytes(const GraphCSR& csr) { return csr.owned_bytes(); }
+
+// builds a missing form under the graph's lock, so concurrent requests convert it once
+template <typename Form, typename Convert>
+static shared_ptr<const Form> derive(DerivedForms& derived, shared_ptr<const Form>& slot, int num_threads,
+                                     Convert convert)
+{
+    lock_guard<mutex> guard(derived.lock);
+    if (slot)
+        return slot;
+
+    shared_ptr<const Form> form;
+    {
+        ThreadTeam team(num_threads);
+        form = make_shared<const Form>(convert());
+    }
+    if (!derived.store || derived.store->add_derived(derived.id, form_bytes(*form)))
+        slot = form;
+    return form;
+}
+
+shared_ptr<const GraphMatrix> stored_matrix(const StoredGraph& graph, int num_threads)
+{
+    if (graph.matrix) return graph.matrix;
+    if (!graph.csr) return nullptr;
+    return derive(*graph.derived, graph.derived->matrix, num_threads, [&] { return csr_to_matrix(*graph.csr); });
+}
+
+shared_ptr<const GraphCSR> stored_csr(const StoredGraph& graph, int num_threads)
+{
+    if (graph.csr) return graph.csr;
+    if (!graph.matrix) return nullptr;
+    return derive(*graph.derived, graph.derived->csr, num_threads, [&] { return matrix_to_csr(*graph.matrix); });
+}
+
+GraphStore::GraphStore(size_t budget_bytes) : budget_bytes(budget_bytes), used_bytes(0), next_id(1) {}
+
+string GraphStore::put(const StoredGraph& graph)
+{
+    // the entry gets its own derived forms, starting from any the caller already built
+    StoredGraph stored{ graph.matrix, graph.csr };
+    if (graph.derived) {
+        lock_guard<mutex> guard(graph.derived->lock);
+        stored.derived->matrix = graph.derived->matrix;
+        stored.derived->csr = graph.derived->csr;
+    }
+
+    size_t bytes = stored.memory_bytes();
+    if (bytes > budget_bytes)
+        throw length_error("Graph needs " + to_string(bytes >> 20) + " MB, store budget is " +
+                           to_string(budget_bytes >> 20) + " MB");
+
+    lock_guard<mutex> lock(store_mutex);
+    evict_until_fits(bytes);
+
+    string id = "g" + to_string(next_id++);
+    stored.derived->store = this;
+    stored.derived->id = id;
+    lru.push_front(id);
+    entries[id] = Entry{ stored, bytes, lru.begin() };
+    used_bytes += bytes;
+    return id;
+}
+
+bool GraphStore::get(const string& id, StoredGraph& out)
+{
+    lock_guard<mutex> lock(store_mutex);
+    auto it = entries.find(id);
+    if (it == entries.end())
+        return false;
+
+    lru.splice(lru.begin(), lru, it->second.lru_pos);
+    out = it->second.graph;
+    return true;
+}
+
+bool GraphStore::erase(const string& id)
+{
+    lock_guard<mutex> lock(store_mutex);
+    auto it = entries.find(id);
+    if (it == entries.end())
+        return false;
+
+    used_bytes -= it->second.bytes;
+    lru.erase(it->second.lru_pos);
+    entries.erase(it);
+    return true;
+}
+
+bool GraphStore::add_derived(const string& id, size_t bytes)
+{
+    lock_guard<mutex> lock(store_mutex);
+    auto it = entries.find(id);
+    if (it == entries.end() || it->second.bytes + bytes > budget_bytes)
+        return false;
+
+    // most recently used, so only other graphs are evicted for it
+    lru.splice(lru.begin(), lru, it->second.lru_pos);
+    it->second.bytes += bytes;
+    used_bytes += bytes;
+    evict_until_fits(0);
+    return true;
+}
+
+vector<StoredGraphInfo> GraphStore::list() const
+{
+    lock_guard<mutex> lock(store_mutex);
+    vector<StoredGraphInfo> infos;
+    for (const string& id : lru)
+    {
+        const Entry& entry = entries.at(id);
+        infos.push_back(StoredGraphInfo{ id, entry.graph.num_vert(), entry.bytes });
+    }
+    return infos;
+}
+
+size_t GraphStore::memory_used() const
+{
+    lock_guard<mutex> lock(store_mutex);
+    return used_bytes;
+}
+
+// caller holds the lock; graphs still referenced by running requests stay alive through their shared_ptrs
+void GraphStore::evict_until_fits(size_t incoming_bytes)
+{
+    while (!lru.empty() && used_bytes + incoming_bytes > budget_bytes)
+    {
+        auto it = entries.find(lru.back());
+        used_bytes -= it->second.bytes;
+        entries.erase(it);
+        lru.pop_back();
+    }
+}
+
+GraphStore& graph_store()
+{
+    static GraphStore store([] {
+        const char* env = getenv("GRAPH_STORE_MB");
+        size_t mb = env ? strtoull(env, nullptr, 10) : 1024;
+        return mb << 20;
+    }());
+    return store;
+}
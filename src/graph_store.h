@@ -0,0 +1,94 @@
+#pragma once
+
+#include "graph.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class GraphStore;
+
+// representations built from the one a graph came with, kept for later requests. copies of a
+// StoredGraph share them; once stored, their bytes count against the store entry
+struct DerivedForms
+{
+    std::mutex lock;
+    std::shared_ptr<const GraphMatrix> matrix;
+    std::shared_ptr<const GraphCSR> csr;
+    GraphStore* store = nullptr; // must outlive the graphs taken from it
+    std::string id;
+};
+
+// a graph kept server-side; at least one representation is set, the other is derived on demand
+struct StoredGraph
+{
+    std::shared_ptr<const GraphMatrix> matrix;
+    std::shared_ptr<const GraphCSR> csr;
+    std::shared_ptr<DerivedForms> derived = std::make_shared<DerivedForms>();
+
+    size_t num_vert() const;
+    // including the derived forms built so far
+    size_t memory_bytes() const;
+};
+
+// matrix form of a stored graph, built from the CSR form once if that is all it has. the
+// conversion takes a team of num_threads (0: the whole budget). a form that would not fit the
+// store budget is returned without being kept
+std::shared_ptr<const GraphMatrix> stored_matrix(const StoredGraph& graph, int num_threads = 0);
+// CSR form of a stored graph, built from the matrix form once if that is all it has
+std::shared_ptr<const GraphCSR> stored_csr(const StoredGraph& graph, int num_threads = 0);
+
+struct StoredGraphInfo
+{
+    std::string id;
+    size_t num_vert;
+    size_t memory_bytes;
+};
+
+// in-memory graph store with LRU eviction under a byte budget; all methods are thread-safe
+class GraphStore
+{
+public:
+    explicit GraphStore(size_t budget_bytes);
+
+    // stores the graph and returns its id; evicts least recently used graphs to make room.
+    // throws std::length_error if the graph alone exceeds the budget
+    std::string put(const StoredGraph& graph);
+
+    // returns false if the id is unknown (never stored or already evicted)
+    bool get(const std::string& id, StoredGraph& out);
+
+    bool erase(const std::string& id);
+
+    // counts a representation derived for a stored graph against its entry, evicting others to
+    // make room. false if the entry is gone or the graph would no longer fit the budget
+    bool add_derived(const std::string& id, size_t bytes);
+
+    std::vector<StoredGraphInfo> list() const;
+    size_t memory_used() const;
+    size_t budget() const { return budget_bytes; }
+
+private:
+    struct Entry
+    {
+        StoredGraph graph;
+        size_t bytes;
+        std::list<std::string>::iterator lru_pos;
+    };
+
+    void evict_until_fits(size_t incoming_bytes);
+
+    mutable std::mutex store_mutex;
+    size_t budget_bytes;
+    size_t used_bytes;
+    unsigned long long next_id;
+    std::list<std::string> lru; // most recently used at the front
+    std::unordered_map<std::string, Entry> entries;
+};
+
+// process-wide store; GRAPH_STORE_MB sets its budget (default 1024 MB)
+GraphStore& graph_store();
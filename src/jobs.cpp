@@ -0,0 +1,205 @@
+#include "jobs.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace std;
+
+const char* job_state_name(JobState state)
+{
+    switch (state)
+    {
+    case JobState::Queued: return "queued";
+    case JobState::Running: return "running";
+    case JobState::Done: return "done";
+    case JobState::Failed: return "failed";
+    default: return "cancelled";
+    }
+}
+
+JobQueue::JobQueue(size_t num_workers, size_t max_pending, size_t max_finished)
+    : max_pending(max_pending), max_finished(max_finished), num_running(0), next_id(1), stopping(false)
+{
+    for (size_t i = 0; i < max<size_t>(num_workers, 1); i++)
+        workers.emplace_back(&JobQueue::worker_loop, this);
+}
+
+JobQueue::~JobQueue()
+{
+    {
+        lock_guard<mutex> lock(jobs_mutex);
+        stopping = true;
+        for (auto& entry : jobs)
+            entry.second->progress.cancel();
+    }
+    work_ready.notify_all();
+    for (thread& worker : workers)
+        worker.join();
+}
+
+string JobQueue::submit(const string& kind, Task task)
+{
+    auto job = make_shared<Job>();
+    job->kind = kind;
+    job->task = move(task);
+    job->submitted = Clock::now();
+
+    {
+        lock_guard<mutex> lock(jobs_mutex);
+        if (queue.size() >= max_pending)
+            throw length_error("Job queue is full (" + to_string(max_pending) + " jobs waiting)");
+
+        job->id = "j" + to_string(next_id++);
+        jobs[job->id] = job;
+        queue.push_back(job);
+    }
+    work_ready.notify_one();
+    return job->id;
+}
+
+bool JobQueue::info(const string& id, JobInfo& out) const
+{
+    lock_guard<mutex> lock(jobs_mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end())
+        return false;
+    out = snapshot(*it->second);
+    return true;
+}
+
+bool JobQueue::result(const string& id, string& out) const
+{
+    lock_guard<mutex> lock(jobs_mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end() || it->second->state != JobState::Done)
+        return false;
+    out = it->second->result;
+    return true;
+}
+
+bool JobQueue::cancel(const string& id)
+{
+    lock_guard<mutex> lock(jobs_mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end())
+        return false;
+
+    shared_ptr<Job> job = it->second;
+    job->progress.cancel();
+    if (job->state == JobState::Queued)
+    {
+        queue.erase(find(queue.begin(), queue.end(), job));
+        finish(job, JobState::Cancelled);
+    }
+    return true;
+}
+
+vector<JobInfo> JobQueue::list() const
+{
+    lock_guard<mutex> lock(jobs_mutex);
+    vector<JobInfo> infos;
+    for (const auto& entry : jobs)
+        infos.push_back(snapshot(*entry.second));
+    sort(infos.begin(), infos.end(), [](const JobInfo& a, const JobInfo& b) {
+        return a.id.size() != b.id.size() ? a.id.size() < b.id.size() : a.id < b.id;
+    });
+    return infos;
+}
+
+size_t JobQueue::pending() const
+{
+    lock_guard<mutex> lock(jobs_mutex);
+    return queue.size();
+}
+
+size_t JobQueue::running() const
+{
+    lock_guard<mutex> lock(jobs_mutex);
+    return num_running;
+}
+
+void JobQueue::worker_loop()
+{
+    unique_lock<mutex> lock(jobs_mutex);
+    while (true)
+    {
+        work_ready.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (stopping)
+            return;
+
+        shared_ptr<Job> job = queue.front();
+        queue.pop_front();
+        job->state = JobState::Running;
+        job->started = Clock::now();
+        num_running++;
+
+        lock.unlock();
+        JobState state = JobState::Done;
+        string output;
+        try {
+            output = job->task(job->progress);
+        } catch (const OperationCancelled&) {
+            state = JobState::Cancelled;
+        } catch (const exception& e) {
+            state = JobState::Failed;
+            output = e.what();
+        }
+        lock.lock();
+
+        num_running--;
+        if (state == JobState::Done)
+            job->result = move(output);
+        else if (state == JobState::Failed)
+            job->error = move(output);
+        finish(job, state);
+    }
+}
+
+// the task is dropped here so graphs it captured are released as soon as the job ends
+void JobQueue::finish(const shared_ptr<Job>& job, JobState state)
+{
+    job->state = state;
+    job->finished = Clock::now();
+    job->task = nullptr;
+
+    history.push_back(job->id);
+    while (history.size() > max_finished)
+    {
+        jobs.erase(history.front());
+        history.pop_front();
+    }
+}
+
+JobInfo JobQueue::snapshot(const Job& job) const
+{
+    auto ms = [](Clock::duration d) { return chrono::duration<double, milli>(d).count(); };
+    Clock::time_point now = Clock::now();
+
+    JobInfo info;
+    info.id = job.id;
+    info.kind = job.kind;
+    info.state = job.state;
+    info.progress = job.state == JobState::Done ? 1.0 : job.progress.fraction();
+    info.error = job.error;
+
+    bool started = job.state == JobState::Running || job.state == JobState::Done || job.state == JobState::Failed ||
+                   (job.state == JobState::Cancelled && job.started != Clock::time_point());
+    bool ended = job.state != JobState::Queued && job.state != JobState::Running;
+
+    info.queued_ms = ms((started ? job.started : (ended ? job.finished : now)) - job.submitted);
+    info.running_ms = started ? ms((ended ? job.finished : now) - job.started) : 0.0;
+    return info;
+}
+
+static size_t env_size(const char* name, size_t fallback)
+{
+    const char* env = getenv(name);
+    return env ? strtoull(env, nullptr, 10) : fallback;
+}
+
+JobQueue& job_queue()
+{
+    static JobQueue queue(env_size("GRAPH_JOB_WORKERS", 1), env_size("GRAPH_JOB_QUEUE", 16), 256);
+    return queue;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "progress.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class JobState { Queued, Running, Done, Failed, Cancelled };
+
+const char* job_state_name(JobState state);
+
+// snapshot of one job for status queries
+struct JobInfo
+{
+    std::string id;
+    std::string kind;
+    JobState state;
+    double progress;      // 0..1, from the algorithm's ProgressControl
+    double queued_ms;     // time spent waiting for a worker
+    double running_ms;    // time spent running so far (or in total once finished)
+    std::string error;    // set for Failed jobs
+};
+
+// bounded executor for long-running algorithm calls. a fixed set of workers runs jobs in
+// submission order; each job may use a whole OpenMP team, so the default is a single worker
+// and the pending queue has a hard cap. all methods are thread-safe
+class JobQueue
+{
+public:
+    // a task returns its result body; it should poll the control and throw OperationCancelled
+    typedef std::function<std::string(ProgressControl&)> Task;
+
+    JobQueue(size_t num_workers, size_t max_pending, size_t max_finished);
+    ~JobQueue();
+
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+
+    // queues the task and returns its id; throws std::length_error when max_pending jobs are waiting
+    std::string submit(const std::string& kind, Task task);
+
+    // returns false if the id is unknown (never submitted or already dropped from history)
+    bool info(const std::string& id, JobInfo& out) const;
+
+    // result body of a Done job; returns false for unknown ids and jobs that are not Done
+    bool result(const std::string& id, std::string& out) const;
+
+    // queued jobs are cancelled at once, running jobs stop at their next cancellation check.
+    // returns false if the id is unknown
+    bool cancel(const std::string& id);
+
+    std::vector<JobInfo> list() const;
+    size_t pending() const;
+    size_t running() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Job
+    {
+        std::string id;
+        std::string kind;
+        Task task;
+        ProgressControl progress;
+        JobState state = JobState::Queued;
+        std::string result;
+        std::string error;
+        Clock::time_point submitted;
+        Clock::time_point started;
+        Clock::time_point finished;
+    };
+
+    void worker_loop();
+    void finish(const std::shared_ptr<Job>& job, JobState state); // caller holds the lock
+    JobInfo snapshot(const Job& job) const;                       // caller holds the lock
+
+    mutable std::mutex jobs_mutex;
+    std::condition_variable work_ready;
+    std::deque<std::shared_ptr<Job>> queue;
+    std::unordered_map<std::string, std::shared_ptr<Job>> jobs;
+    std::deque<std::string> history; // finished job ids, oldest first
+    std::vector<std::thread> workers;
+    size_t max_pending;
+    size_t max_finished;
+    size_t num_running;
+    unsigned long long next_id;
+    bool stopping;
+};
+
+// process-wide queue; GRAPH_JOB_WORKERS (default 1) and GRAPH_JOB_QUEUE (default 16) size it
+JobQueue& job_queue();
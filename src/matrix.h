@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+#include "flat_array.h"
+
+// allocator handing out 64-byte (cache line) aligned blocks
+template <typename T, size_t Align = 64>
+struct AlignedAllocator
+{
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind { typedef AlignedAllocator<U, Align> other; };
+
+    AlignedAllocator() noexcept {}
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        size_t bytes = (n * sizeof(T) + Align - 1) / Align * Align;
+        void* p = std::aligned_alloc(Align, bytes == 0 ? Align : bytes);
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t) noexcept { std::free(p); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Align>&) const noexcept { return false; }
+};
+
+// non-owning strided view over a row-major matrix; view[i] is a pointer to row i
+template <typename T>
+struct BasicMatrixView
+{
+    T* base;
+    size_t rows;
+    size_t cols;
+    size_t stride; // elements between the starts of consecutive rows
+
+    BasicMatrixView() : base(nullptr), rows(0), cols(0), stride(0) {}
+    BasicMatrixView(T* base, size_t rows, size_t cols, size_t stride)
+        : base(base), rows(rows), cols(cols), stride(stride) {}
+
+    // views over int convert to views over const int
+    template <typename U>
+    BasicMatrixView(const BasicMatrixView<U>& other)
+        : base(other.base), rows(other.rows), cols(other.cols), stride(other.stride) {}
+
+    T* operator[](size_t i) const { return base + i * stride; }
+
+    // sub-view of rows [row, row + nrows) and columns [col, col + ncols)
+    BasicMatrixView block(size_t row, size_t col, size_t nrows, size_t ncols) const
+    {
+        return BasicMatrixView(base + row * stride + col, nrows, ncols, stride);
+    }
+};
+
+typedef BasicMatrixView<int> MatrixView;
+typedef BasicMatrixView<const int> ConstMatrixView;
+
+// dense square int matrix stored in one aligned buffer, rows padded to a cache line.
+// the buffer may also be a read-only view (see FlatArray), copied on first write
+class Matrix
+{
+public:
+    static const size_t ROW_ALIGN = 64 / sizeof(int);
+
+    Matrix() : n(0), row_stride(0) {}
+
+    Matrix(size_t n, int fill) : n(n), row_stride(padded_stride(n)), cells(n * padded_stride(n), fill) {}
+
+    // n x n matrix over existing rows stride elements apart; owner keeps data valid
+    static Matrix view(const int* data, size_t n, size_t stride, std::shared_ptr<const void> owner)
+    {
+        Matrix matrix;
+        matrix.n = n;
+        matrix.row_stride = stride;
+        matrix.cells = FlatArray<int, AlignedAllocator<int> >::view(data, n * stride, std::move(owner));
+        return matrix;
+    }
+
+    size_t size() const { return n; }
+    size_t stride() const { return row_stride; }
+    bool empty() const { return n == 0; }
+    bool is_view() const { return cells.is_view(); }
+    size_t owned_bytes() const { return cells.owned_bytes(); }
+
+    int* operator[](size_t i) { return cells.data() + i * row_stride; }
+    const int* operator[](size_t i) const { return cells.data() + i * row_stride; }
+
+    int* data() { return cells.data(); }
+    const int* data() const { return cells.data(); }
+
+    MatrixView view() { return MatrixView(cells.data(), n, n, row_stride); }
+    ConstMatrixView view() const { return ConstMatrixView(cells.data(), n, n, row_stride); }
+
+    // same size and cells; row padding is not compared
+    bool operator==(const Matrix& other) const
+    {
+        if (n != other.n) return false;
+        for (size_t i = 0; i < n; i++)
+            if (!std::equal((*this)[i], (*this)[i] + n, other[i])) return false;
+        return true;
+    }
+    bool operator!=(const Matrix& other) const { return !(*this == other); }
+
+    static size_t padded_stride(size_t cols)
+    {
+        return (cols + ROW_ALIGN - 1) / ROW_ALIGN * ROW_ALIGN;
+    }
+
+private:
+    size_t n;
+    size_t row_stride;
+    FlatArray<int, AlignedAllocator<int> > cells;
+};
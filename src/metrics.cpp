@@ -0,0 +1,252 @@
+#include "metrics.h"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+// threads take shards round robin, so up to METRIC_SHARDS threads never share one
+static int thread_shard()
+{
+    static atomic<unsigned> next_shard{0};
+    thread_local int shard = static_cast<int>(next_shard.fetch_add(1, memory_order_relaxed) % METRIC_SHARDS);
+    return shard;
+}
+
+void ShardedCounter::add(uint64_t n)
+{
+    shards[thread_shard()].value.fetch_add(n, memory_order_relaxed);
+}
+
+uint64_t ShardedCounter::value() const
+{
+    uint64_t sum = 0;
+    for (const Shard& shard : shards)
+        sum += shard.value.load(memory_order_relaxed);
+    return sum;
+}
+
+int LatencyHistogram::bucket_of(uint64_t us)
+{
+    const uint64_t sub = 1u << SUB_BITS;
+    if (us < sub)
+        return static_cast<int>(us);
+
+    int exponent = 63 - __builtin_clzll(us);
+    if (exponent >= MAX_EXPONENT)
+        return BUCKETS - 1;
+    return (exponent - SUB_BITS + 1) * static_cast<int>(sub) + static_cast<int>((us >> (exponent - SUB_BITS)) - sub);
+}
+
+uint64_t LatencyHistogram::bucket_lower(int bucket)
+{
+    const int sub = 1 << SUB_BITS;
+    if (bucket < sub)
+        return static_cast<uint64_t>(bucket);
+    int group = bucket / sub;
+    return static_cast<uint64_t>(sub + bucket % sub) << (group - 1);
+}
+
+uint64_t LatencyHistogram::bucket_upper(int bucket)
+{
+    const int sub = 1 << SUB_BITS;
+    if (bucket < sub)
+        return static_cast<uint64_t>(bucket) + 1;
+    return bucket_lower(bucket) + (uint64_t(1) << (bucket / sub - 1));
+}
+
+void LatencyHistogram::record(double seconds)
+{
+    if (!(seconds > 0))
+        seconds = 0;
+    double us = seconds * 1e6;
+    int bucket = us >= 0x1p62 ? BUCKETS - 1 : bucket_of(static_cast<uint64_t>(us));
+
+    Shard& shard = shards[thread_shard()];
+    shard.buckets[bucket].fetch_add(1, memory_order_relaxed);
+    shard.sum_ns.fetch_add(static_cast<uint64_t>(min(seconds * 1e9, 0x1p62)), memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    Snapshot snap;
+    snap.buckets.assign(BUCKETS, 0);
+    uint64_t sum_ns = 0;
+    for (const Shard& shard : shards) {
+        for (int b = 0; b < BUCKETS; b++)
+            snap.buckets[b] += shard.buckets[b].load(memory_order_relaxed);
+        sum_ns += shard.sum_ns.load(memory_order_relaxed);
+    }
+    // the count is summed from the buckets so it always agrees with them during concurrent updates
+    for (uint64_t n : snap.buckets)
+        snap.count += n;
+    snap.sum_seconds = sum_ns / 1e9;
+    return snap;
+}
+
+uint64_t LatencyHistogram::Snapshot::count_below(uint64_t upper_us) const
+{
+    uint64_t total = 0;
+    for (int b = 0; b < BUCKETS && bucket_upper(b) <= upper_us; b++)
+        total += buckets[b];
+    return total;
+}
+
+double LatencyHistogram::Snapshot::quantile(double q) const
+{
+    if (count == 0)
+        return 0.0;
+    uint64_t rank = static_cast<uint64_t>(ceil(q * count));
+    if (rank < 1) rank = 1;
+
+    uint64_t seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += buckets[b];
+        if (seen >= rank)
+            return bucket_upper(b) / 1e6;
+    }
+    return bucket_upper(BUCKETS - 1) / 1e6;
+}
+
+RequestMetrics& MetricsRegistry::endpoint(const string& method, const string& endpoint)
+{
+    lock_guard<mutex> guard(lock);
+    auto& series = endpoints[{method, endpoint}];
+    if (!series)
+        series.reset(new RequestMetrics());
+    return *series;
+}
+
+AlgorithmMetrics& MetricsRegistry::algorithm(const string& variant)
+{
+    lock_guard<mutex> guard(lock);
+    auto& series = algorithms[variant];
+    if (!series)
+        series.reset(new AlgorithmMetrics());
+    return *series;
+}
+
+static string label_value(const string& value)
+{
+    string escaped;
+    for (char c : value) {
+        if (c == '\\' || c == '"') escaped += '\\';
+        if (c == '\n') { escaped += "\\n"; continue; }
+        escaped += c;
+    }
+    return escaped;
+}
+
+// whole numbers print in full, e.g. byte counts that setprecision would round
+static void gauge_value(ostream& out, double value)
+{
+    if (value == floor(value) && fabs(value) < 0x1p53)
+        out << static_cast<long long>(value);
+    else
+        out << value;
+}
+
+static void family(ostream& out, const char* name, const char* type, const char* help)
+{
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " " << type << "\n";
+}
+
+// cumulative buckets every factor of 4 from 16 us up to about 4.8 hours, then the HDR quantiles
+// as a separate gauge family
+static const uint64_t EXPORT_FIRST_US = 16;
+static const int EXPORT_BUCKETS = 16;
+static const double EXPORT_QUANTILES[] = { 0.5, 0.9, 0.99, 0.999 };
+
+static void histogram_series(ostream& out, const char* name, const string& labels,
+                             const LatencyHistogram::Snapshot& snap)
+{
+    uint64_t upper = EXPORT_FIRST_US;
+    for (int i = 0; i < EXPORT_BUCKETS; i++, upper *= 4)
+        out << name << "_bucket{" << labels << ",le=\"" << upper / 1e6 << "\"} " << snap.count_below(upper) << "\n";
+    out << name << "_bucket{" << labels << ",le=\"+Inf\"} " << snap.count << "\n";
+    out << name << "_sum{" << labels << "} " << snap.sum_seconds << "\n";
+    out << name << "_count{" << labels << "} " << snap.count << "\n";
+}
+
+static void quantile_series(ostream& out, const char* name, const string& labels,
+                            const LatencyHistogram::Snapshot& snap)
+{
+    for (double q : EXPORT_QUANTILES)
+        out << name << "{" << labels << ",quantile=\"" << q << "\"} " << snap.quantile(q) << "\n";
+}
+
+string MetricsRegistry::prometheus(const vector<MetricGauge>& gauges) const
+{
+    // copy the series list so the scrape formats without holding the lock
+    vector<pair<string, const RequestMetrics*>> endpoint_series;
+    vector<pair<string, const AlgorithmMetrics*>> algorithm_series;
+    {
+        lock_guard<mutex> guard(lock);
+        for (const auto& entry : endpoints)
+            endpoint_series.emplace_back("method=\"" + label_value(entry.first.first) + "\",endpoint=\"" +
+                                         label_value(entry.first.second) + "\"", entry.second.get());
+        for (const auto& entry : algorithms)
+            algorithm_series.emplace_back("algorithm=\"" + label_value(entry.first) + "\"", entry.second.get());
+    }
+
+    stringstream out;
+    out << setprecision(9);
+
+    family(out, "graph_http_requests_total", "counter", "HTTP requests handled.");
+    for (const auto& s : endpoint_series)
+        out << "graph_http_requests_total{" << s.first << "} " << s.second->requests.value() << "\n";
+    family(out, "graph_http_errors_total", "counter", "HTTP replies with a 4xx or 5xx status.");
+    for (const auto& s : endpoint_series)
+        out << "graph_http_errors_total{" << s.first << "} " << s.second->errors.value() << "\n";
+    family(out, "graph_http_request_bytes_total", "counter", "Request body bytes received.");
+    for (const auto& s : endpoint_series)
+        out << "graph_http_request_bytes_total{" << s.first << "} " << s.second->bytes_in.value() << "\n";
+    family(out, "graph_http_response_bytes_total", "counter", "Response body bytes sent.");
+    for (const auto& s : endpoint_series)
+        out << "graph_http_response_bytes_total{" << s.first << "} " << s.second->bytes_out.value() << "\n";
+
+    vector<LatencyHistogram::Snapshot> endpoint_latency;
+    for (const auto& s : endpoint_series)
+        endpoint_latency.push_back(s.second->latency.snapshot());
+    family(out, "graph_http_request_duration_seconds", "histogram", "Time from routing to the reply being written.");
+    for (size_t i = 0; i < endpoint_series.size(); i++)
+        histogram_series(out, "graph_http_request_duration_seconds", endpoint_series[i].first, endpoint_latency[i]);
+    family(out, "graph_http_request_duration_quantile_seconds", "gauge",
+           "Request latency quantiles from the HDR histogram, as bucket upper bounds.");
+    for (size_t i = 0; i < endpoint_series.size(); i++)
+        quantile_series(out, "graph_http_request_duration_quantile_seconds", endpoint_series[i].first, endpoint_latency[i]);
+
+    family(out, "graph_algorithm_runs_total", "counter", "Algorithm runs, synchronous and as jobs.");
+    for (const auto& s : algorithm_series)
+        out << "graph_algorithm_runs_total{" << s.first << "} " << s.second->runs.value() << "\n";
+    family(out, "graph_algorithm_errors_total", "counter", "Algorithm runs that threw, including cancellations.");
+    for (const auto& s : algorithm_series)
+        out << "graph_algorithm_errors_total{" << s.first << "} " << s.second->errors.value() << "\n";
+
+    vector<LatencyHistogram::Snapshot> algorithm_latency;
+    for (const auto& s : algorithm_series)
+        algorithm_latency.push_back(s.second->latency.snapshot());
+    family(out, "graph_algorithm_duration_seconds", "histogram", "Algorithm run time including the report.");
+    for (size_t i = 0; i < algorithm_series.size(); i++)
+        histogram_series(out, "graph_algorithm_duration_seconds", algorithm_series[i].first, algorithm_latency[i]);
+    family(out, "graph_algorithm_duration_quantile_seconds", "gauge",
+           "Algorithm run time quantiles from the HDR histogram, as bucket upper bounds.");
+    for (size_t i = 0; i < algorithm_series.size(); i++)
+        quantile_series(out, "graph_algorithm_duration_quantile_seconds", algorithm_series[i].first, algorithm_latency[i]);
+
+    for (const MetricGauge& gauge : gauges) {
+        family(out, gauge.name, "gauge", gauge.help);
+        out << gauge.name << " ";
+        gauge_value(out, gauge.value);
+        out << "\n";
+    }
+    return out.str();
+}
+
+MetricsRegistry& metrics()
+{
+    static MetricsRegistry instance;
+    return instance;
+}
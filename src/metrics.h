@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// process-wide server metrics in the Prometheus text format. every update is a relaxed atomic add
+// on a shard chosen once per thread, so concurrent requests never share a cache line; a scrape
+// sums the shards. series lookups take a lock, so callers look a series up once and keep it
+const int METRIC_SHARDS = 16;
+
+class ShardedCounter
+{
+public:
+    void add(uint64_t n = 1);
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> value{0};
+    };
+    Shard shards[METRIC_SHARDS];
+};
+
+// HDR-style latency histogram: microsecond buckets, 8 linear sub-buckets per power of two, so a
+// recorded value is off by at most 12.5%. covers 1 us up to about 19 hours; longer values are clamped
+class LatencyHistogram
+{
+public:
+    static const int SUB_BITS = 3;
+    static const int MAX_EXPONENT = 36;
+    static const int BUCKETS = (MAX_EXPONENT - SUB_BITS + 1) * (1 << SUB_BITS);
+
+    void record(double seconds);
+
+    struct Snapshot
+    {
+        std::vector<uint64_t> buckets;
+        uint64_t count = 0;
+        double sum_seconds = 0;
+
+        // observations at or below the given bound, summed over whole buckets
+        uint64_t count_below(uint64_t upper_us) const;
+        // upper edge of the bucket holding the q-th observation, in seconds; 0 when empty
+        double quantile(double q) const;
+    };
+    Snapshot snapshot() const;
+
+    static int bucket_of(uint64_t us);
+    static uint64_t bucket_lower(int bucket);
+    static uint64_t bucket_upper(int bucket);
+
+private:
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> buckets[BUCKETS] = {};
+        std::atomic<uint64_t> sum_ns{0};
+    };
+    Shard shards[METRIC_SHARDS];
+};
+
+struct RequestMetrics
+{
+    ShardedCounter requests;
+    ShardedCounter errors;    // 4xx and 5xx replies
+    ShardedCounter bytes_in;  // request bodies
+    ShardedCounter bytes_out; // response bodies
+    LatencyHistogram latency;
+};
+
+struct AlgorithmMetrics
+{
+    ShardedCounter runs;
+    ShardedCounter errors; // bad options, cancellations and failures
+    LatencyHistogram latency;
+};
+
+// values read at scrape time
+struct MetricGauge
+{
+    const char* name;
+    const char* help;
+    double value;
+};
+
+class MetricsRegistry
+{
+public:
+    // series are created on first use and live as long as the registry
+    RequestMetrics& endpoint(const std::string& method, const std::string& endpoint);
+    AlgorithmMetrics& algorithm(const std::string& variant);
+
+    // every series plus the given gauges, in the text exposition format
+    std::string prometheus(const std::vector<MetricGauge>& gauges) const;
+
+private:
+    mutable std::mutex lock;
+    std::map<std::pair<std::string, std::string>, std::unique_ptr<RequestMetrics>> endpoints;
+    std::map<std::string, std::unique_ptr<AlgorithmMetrics>> algorithms;
+};
+
+MetricsRegistry& metrics();
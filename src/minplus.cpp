@@ -0,0 +1,159 @@
+#include "minplus.h"
+#include "graph.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MINPLUS_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// with d_ik >= 0 an INF in row_k always gives d_ik + INF >= INF >= row_i[j], so plain add+min is exact.
+// a negative d_ik (negative edge weights) would pull INF below INF, so those rows mask INF lanes out
+static void minplus_row_scalar(int* row_i, const int* row_k, int d_ik, size_t n)
+{
+    if (d_ik >= 0)
+    {
+        for (size_t j = 0; j < n; j++)
+            row_i[j] = min(row_i[j], d_ik + row_k[j]);
+    }
+    else
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            int cand = row_k[j] == INF ? INF : d_ik + row_k[j];
+            row_i[j] = min(row_i[j], cand);
+        }
+    }
+}
+
+#ifdef MINPLUS_X86
+
+__attribute__((target("sse4.1")))
+static void minplus_row_sse41(int* row_i, const int* row_k, int d_ik, size_t n)
+{
+    const __m128i d = _mm_set1_epi32(d_ik);
+    const __m128i inf = _mm_set1_epi32(INF);
+    const bool masked = d_ik < 0;
+    size_t j = 0;
+
+    for (; j + 4 <= n; j += 4)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row_i + j));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row_k + j));
+        __m128i cand = _mm_add_epi32(d, b);
+        if (masked)
+            cand = _mm_blendv_epi8(cand, inf, _mm_cmpeq_epi32(b, inf));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row_i + j), _mm_min_epi32(a, cand));
+    }
+    minplus_row_scalar(row_i + j, row_k + j, d_ik, n - j);
+}
+
+__attribute__((target("avx2")))
+static void minplus_row_avx2(int* row_i, const int* row_k, int d_ik, size_t n)
+{
+    const __m256i d = _mm256_set1_epi32(d_ik);
+    const __m256i inf = _mm256_set1_epi32(INF);
+    const bool masked = d_ik < 0;
+    size_t j = 0;
+
+    for (; j + 8 <= n; j += 8)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row_i + j));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row_k + j));
+        __m256i cand = _mm256_add_epi32(d, b);
+        if (masked)
+            cand = _mm256_blendv_epi8(cand, inf, _mm256_cmpeq_epi32(b, inf));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(row_i + j), _mm256_min_epi32(a, cand));
+    }
+    minplus_row_scalar(row_i + j, row_k + j, d_ik, n - j);
+}
+
+__attribute__((target("avx512f")))
+static void minplus_row_avx512(int* row_i, const int* row_k, int d_ik, size_t n)
+{
+    const __m512i d = _mm512_set1_epi32(d_ik);
+    const __m512i inf = _mm512_set1_epi32(INF);
+    const bool masked = d_ik < 0;
+
+    // the tail is handled with a lane mask instead of a scalar loop
+    for (size_t j = 0; j < n; j += 16)
+    {
+        __mmask16 lanes = n - j >= 16 ? static_cast<__mmask16>(0xFFFF)
+                                      : static_cast<__mmask16>((1u << (n - j)) - 1);
+        __m512i a = _mm512_maskz_loadu_epi32(lanes, row_i + j);
+        __m512i b = _mm512_maskz_loadu_epi32(lanes, row_k + j);
+        __m512i cand = _mm512_add_epi32(d, b);
+        if (masked)
+            cand = _mm512_mask_blend_epi32(_mm512_cmpeq_epi32_mask(b, inf), cand, inf);
+        _mm512_mask_storeu_epi32(row_i + j, lanes, _mm512_mask_min_epi32(a, lanes, a, cand));
+    }
+}
+
+#endif
+
+MinPlusRowFn minplus_row_kernel(SimdIsa isa)
+{
+    switch (isa)
+    {
+    case SimdIsa::Scalar:
+        return minplus_row_scalar;
+#ifdef MINPLUS_X86
+    case SimdIsa::SSE41:
+        return __builtin_cpu_supports("sse4.1") ? minplus_row_sse41 : nullptr;
+    case SimdIsa::AVX2:
+        return __builtin_cpu_supports("avx2") ? minplus_row_avx2 : nullptr;
+    case SimdIsa::AVX512:
+        return __builtin_cpu_supports("avx512f") ? minplus_row_avx512 : nullptr;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+const char* simd_isa_name(SimdIsa isa)
+{
+    switch (isa)
+    {
+    case SimdIsa::SSE41: return "SSE4.1";
+    case SimdIsa::AVX2: return "AVX2";
+    case SimdIsa::AVX512: return "AVX-512";
+    default: return "scalar";
+    }
+}
+
+// GRAPH_SIMD=scalar|sse4.1|avx2|avx512 caps the instruction set, e.g. to benchmark the fallbacks
+static SimdIsa simd_isa_cap()
+{
+    const char* env = getenv("GRAPH_SIMD");
+    if (!env) return SimdIsa::AVX512;
+    if (strcmp(env, "scalar") == 0) return SimdIsa::Scalar;
+    if (strcmp(env, "sse4.1") == 0) return SimdIsa::SSE41;
+    if (strcmp(env, "avx2") == 0) return SimdIsa::AVX2;
+    return SimdIsa::AVX512;
+}
+
+SimdIsa detect_simd_isa()
+{
+    static const SimdIsa isa = [] {
+        const SimdIsa order[] = { SimdIsa::AVX512, SimdIsa::AVX2, SimdIsa::SSE41 };
+        SimdIsa cap = simd_isa_cap();
+        for (SimdIsa candidate : order)
+        {
+            if (candidate <= cap && minplus_row_kernel(candidate))
+                return candidate;
+        }
+        return SimdIsa::Scalar;
+    }();
+    return isa;
+}
+
+void minplus_row(int* row_i, const int* row_k, int d_ik, size_t n)
+{
+    static const MinPlusRowFn kernel = minplus_row_kernel(detect_simd_isa());
+    kernel(row_i, row_k, d_ik, n);
+}
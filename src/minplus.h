@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+// instruction sets the min-plus kernel can be built for, slowest first
+enum class SimdIsa { Scalar, SSE41, AVX2, AVX512 };
+
+// row_i[j] = min(row_i[j], d_ik + row_k[j]) for j < n, with INF in row_k never becoming finite.
+// callers skip rows where d_ik == INF; since every entry is <= INF = INT_MAX / 2 the add cannot overflow
+typedef void (*MinPlusRowFn)(int* row_i, const int* row_k, int d_ik, size_t n);
+
+// best instruction set supported by this CPU (cached after the first call)
+SimdIsa detect_simd_isa();
+
+// kernel for a specific instruction set, nullptr if the CPU or compiler cannot run it
+MinPlusRowFn minplus_row_kernel(SimdIsa isa);
+
+const char* simd_isa_name(SimdIsa isa);
+
+// relax one row with the best kernel for this CPU
+void minplus_row(int* row_i, const int* row_k, int d_ik, size_t n);
@@ -1,6 +1,9 @@
-#include "httplib.h"
-#include "json.hpp"
-#include "graph.h"
+#include "parallel_graph.h"
+#include "minplus.h"
+#include "thread_budget.h"
+#include "bench_stats.h"
+#include "trace.h"
+#include "shortest_paths.h"
 
 #include <iostream>
 #include <fstream>
@@ -13,12 +16,14 @@
 #include <vector>
 #include <atomic>
 #include <queue>
+#include <cmath>
+#include <random>
+#include <unordered_map>
 
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
-using json = nlohmann::json;
 using namespace std;
 using namespace std::chrono;
 
@@ -47,21 +52,182 @@ string format_time(double time_ms)
     return ss.str();
 }
 
-pair<vector<vector<int>>, string> connected_components_algorithm_parallel(const GraphAdjList& graph, int num_threads = 0) 
+ComponentsResult connected_components_algorithm_parallel(const GraphAdjList& graph, int num_threads) 
 {
-    auto start_time = high_resolution_clock::now();
-    
-    #ifdef _OPENMP
-    if (num_threads > 0) {
-        omp_set_num_threads(num_threads);
+    return connected_components_algorithm_parallel(list_to_csr(graph), num_threads);
+}
+
+// in-place exclusive prefix sum, one block per thread; returns the total
+static uint64_t parallel_exclusive_scan(vector<uint64_t>& values)
+{
+    const size_t n = values.size();
+    vector<uint64_t> block_sums;
+    uint64_t total = 0;
+
+    #pragma omp parallel
+    {
+        #ifdef _OPENMP
+        size_t num_blocks = omp_get_num_threads();
+        size_t block = omp_get_thread_num();
+        #else
+        size_t num_blocks = 1;
+        size_t block = 0;
+        #endif
+        size_t lo = n * block / num_blocks;
+        size_t hi = n * (block + 1) / num_blocks;
+
+        #pragma omp single
+        block_sums.assign(num_blocks + 1, 0);
+
+        uint64_t sum = 0;
+        for (size_t i = lo; i < hi; ++i)
+            sum += values[i];
+        block_sums[block + 1] = sum;
+
+        #pragma omp barrier
+        #pragma omp single
+        {
+            for (size_t b = 0; b < num_blocks; ++b)
+                block_sums[b + 1] += block_sums[b];
+            total = block_sums[num_blocks];
+        }
+
+        uint64_t running = block_sums[block];
+        for (size_t i = lo; i < hi; ++i) {
+            uint64_t v = values[i];
+            values[i] = running;
+            running += v;
+        }
     }
-    int actual_threads = omp_get_max_threads();
-    #else
-    int actual_threads = 1;
-    #endif
+    return total;
+}
+
+// one stable counting-sort pass over 8 bits of key; per-thread histograms keep it deterministic
+template <typename Key>
+static void radix_pass(const vector<Key>& key, const vector<int>& order, vector<Key>& key_out, vector<int>& order_out, unsigned shift)
+{
+    const size_t n = key.size();
+    const size_t BUCKETS = 256;
+    vector<size_t> hist;
+
+    #pragma omp parallel
+    {
+        #ifdef _OPENMP
+        size_t num_blocks = omp_get_num_threads();
+        size_t block = omp_get_thread_num();
+        #else
+        size_t num_blocks = 1;
+        size_t block = 0;
+        #endif
+        size_t lo = n * block / num_blocks;
+        size_t hi = n * (block + 1) / num_blocks;
+
+        #pragma omp single
+        hist.assign(num_blocks * BUCKETS, 0);
+
+        size_t* my_hist = hist.data() + block * BUCKETS;
+        for (size_t i = lo; i < hi; ++i)
+            my_hist[(key[i] >> shift) & (BUCKETS - 1)]++;
+
+        // bucket-major, thread-minor positions make the pass stable
+        #pragma omp barrier
+        #pragma omp single
+        {
+            size_t running = 0;
+            for (size_t b = 0; b < BUCKETS; ++b) {
+                for (size_t t = 0; t < num_blocks; ++t) {
+                    size_t count = hist[t * BUCKETS + b];
+                    hist[t * BUCKETS + b] = running;
+                    running += count;
+                }
+            }
+        }
+
+        for (size_t i = lo; i < hi; ++i) {
+            size_t pos = my_hist[(key[i] >> shift) & (BUCKETS - 1)]++;
+            key_out[pos] = key[i];
+            order_out[pos] = order[i];
+        }
+    }
+}
+
+template <typename VertexId>
+ComponentList components_from_labels(const vector<VertexId>& labels)
+{
+    const size_t n = labels.size();
+    ComponentList components;
+    if (n == 0)
+        return components;
+
+    // relabel: representatives get dense ids in ascending vertex order
+    TraceSpan relabel_span("components.relabel");
+    vector<uint64_t> comp_id(n);
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; ++i) 
+    {
+        comp_id[i] = labels[i] == i ? 1 : 0;
+    }
+    const size_t num_components = parallel_exclusive_scan(comp_id);
+
+    vector<VertexId> key(n);
+    vector<int> order(n);
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; ++i) 
+    {
+        key[i] = static_cast<VertexId>(comp_id[labels[i]]);
+        order[i] = static_cast<int>(i);
+    }
+    vector<uint64_t>().swap(comp_id);
+    relabel_span.end();
+
+    // LSD radix sort by component id; vertices start ascending and every pass is stable
+    TraceSpan sort_span("components.sort");
+    vector<VertexId> key_tmp(n);
+    vector<int> order_tmp(n);
+    for (unsigned shift = 0; shift < 64 && ((num_components - 1) >> shift) != 0; shift += 8) 
+    {
+        radix_pass(key, order, key_tmp, order_tmp, shift);
+        key.swap(key_tmp);
+        order.swap(order_tmp);
+    }
+
+    sort_span.end();
+
+    // a component starts wherever the sorted key changes
+    TraceSpan offsets_span("components.offsets");
+    components.offsets.assign(num_components + 1, n);
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; ++i) 
+    {
+        if (i == 0 || key[i] != key[i - 1])
+            components.offsets[key[i]] = i;
+    }
+    components.vertices = move(order);
+    return components;
+}
+
+template ComponentList components_from_labels<uint32_t>(const vector<uint32_t>&);
+template ComponentList components_from_labels<uint64_t>(const vector<uint64_t>&);
+
+// vertices per scheduling chunk in the parallel edge sweeps; progress is published and
+// cancellation checked once per chunk, so the per-edge work stays untouched
+static const size_t CC_CHUNK = 1024;
+
+template <typename VertexId>
+ComponentsResult connected_components_algorithm_parallel(const BasicGraphCSR<VertexId>& graph, int num_threads,
+                                                         ProgressControl* progress) 
+{
+    // waits for free cores rather than oversubscribing them; held until return
+    ThreadTeam team(num_threads);
+    int actual_threads = team.size();
+    PerfCounters counters(progress_wants_counters(progress), actual_threads);
+
+    auto start_time = high_resolution_clock::now();
 
+    TraceSpan kernel_span("cc_parallel");
     const size_t num_vertices = graph.num_vert;
-    vector<int> parent(num_vertices);
+    TraceSpan init_span("cc_parallel.init");
+    vector<VertexId> parent(num_vertices);
     
     // init parents in parallel
     #pragma omp parallel for
@@ -69,9 +235,10 @@ pair<vector<vector<int>>, string> connected_components_algorithm_parallel(const
     {
         parent[i] = i;
     }
+    init_span.end();
 
     // find with path compression
-    auto find = [&](int u) 
+    auto find = [&](VertexId u) 
     {
         while (parent[u] != u) {
             parent[u] = parent[parent[u]];  // path compression
@@ -81,7 +248,7 @@ pair<vector<vector<int>>, string> connected_components_algorithm_parallel(const
     };
 
     // lock-free union with CAS
-    auto atomic_union = [&](int u, int v) 
+    auto atomic_union = [&](VertexId u, VertexId v) 
     {
         while (true) {
             u = find(u);
@@ -95,691 +262,570 @@ pair<vector<vector<int>>, string> connected_components_algorithm_parallel(const
         }
     };
 
-    // process edges in parallel with dynamic scheduling
-    #pragma omp parallel for schedule(dynamic, 1024)
-    for (size_t u = 0; u < num_vertices; ++u) 
+    // process edges in parallel with dynamic scheduling, one chunk of vertices at a time.
+    // each thread traces its own share, which shows load imbalance
+    progress_start(progress, graph.num_edges());
+    TraceSpan union_span("cc_parallel.union");
+    #pragma omp parallel
     {
-        for (const auto& neighbor : graph.adjList[u]) 
+        TraceSpan worker_span("cc_parallel.union_worker");
+        #pragma omp for schedule(dynamic, 1) nowait
+        for (size_t first = 0; first < num_vertices; first += CC_CHUNK) 
         {
-            size_t v = neighbor.first;
-            if (u < v) {  // process each edge only once
-                atomic_union(u, v);
+            if (progress_cancelled(progress))
+                continue;
+            size_t last = min(first + CC_CHUNK, num_vertices);
+            for (size_t u = first; u < last; ++u) 
+            {
+                for (uint64_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) 
+                {
+                    size_t v = graph.neighbors[e];
+                    if (u < v) {  // process each edge only once
+                        atomic_union(u, v);
+                    }
+                }
             }
+            progress_advance(progress, graph.offsets[last] - graph.offsets[first]);
         }
     }
+    union_span.end();
+    throw_if_cancelled(progress);
 
-    // final path compression pass
+    // final path compression pass; halving alone can leave a vertex pointing at a non-root
+    TraceSpan compress_span("cc_parallel.compress");
     #pragma omp parallel for
     for (size_t i = 0; i < num_vertices; ++i) 
     {
-        find(i);
+        parent[i] = find(i);
     }
+    compress_span.end();
 
-    // build components using atomic counters
-    vector<vector<int>> components(num_vertices);
-    vector<atomic<size_t>> component_sizes(num_vertices);
-    
-    // first pass: count component sizes
-    #pragma omp parallel for
-    for (size_t i = 0; i < num_vertices; ++i) 
+    ComponentList components = components_from_labels(parent);
+    kernel_span.end();
+
+    auto end_time = high_resolution_clock::now();
+    RunStats stats;
+    stats.algorithm = "cc_parallel";
+    stats.num_vert = num_vertices;
+    stats.num_edges = graph.num_edges() / 2;
+    stats.threads = actual_threads;
+    stats.counters = counters.stop();
+    stats.kernel_ms = duration_cast<microseconds>(end_time - start_time).count() / 1000.0;
+    stats.total_ms = stats.kernel_ms;
+    progress_kernel_time(progress, stats.kernel_ms);
+    progress_counters(progress, stats.counters);
+
+    return ComponentsResult{ move(components), move(stats) };
+}
+
+template ComponentsResult connected_components_algorithm_parallel<uint32_t>(const GraphCSR&, int, ProgressControl*);
+template ComponentsResult connected_components_algorithm_parallel<uint64_t>(const GraphCSR64&, int, ProgressControl*);
+
+// afforest link: hook the higher root under the lower one, retrying until both sides agree
+template <typename VertexId>
+static void afforest_link(vector<VertexId>& comp, VertexId u, VertexId v)
+{
+    VertexId p1 = comp[u];
+    VertexId p2 = comp[v];
+    while (p1 != p2) 
     {
-        int root = parent[i];
-        component_sizes[root]++;
+        VertexId high = max(p1, p2);
+        VertexId low = min(p1, p2);
+        VertexId p_high = comp[high];
+        if (p_high == low) break;
+        if (p_high == high && __sync_bool_compare_and_swap(&comp[high], high, low)) break;
+        p1 = comp[comp[high]];
+        p2 = comp[low];
     }
-    
-    // allocate space
-    #pragma omp parallel for
-    for (size_t i = 0; i < num_vertices; ++i) 
+}
+
+template <typename VertexId>
+static void afforest_compress(vector<VertexId>& comp)
+{
+    #pragma omp parallel for schedule(dynamic, 16384)
+    for (size_t i = 0; i < comp.size(); ++i) 
     {
-        if (component_sizes[i] > 0) 
-        {
-            components[i].reserve(component_sizes[i].load());
-        }
+        while (comp[i] != comp[comp[i]])
+            comp[i] = comp[comp[i]];
     }
+}
+
+// most frequent label among a fixed-seed sample of vertices, with its estimated share
+template <typename VertexId>
+static VertexId afforest_sample_frequent(const vector<VertexId>& comp, double& fraction)
+{
+    const size_t NUM_SAMPLES = 1024;
+    unordered_map<VertexId, size_t> counts;
+    mt19937_64 gen(27491095);
+    uniform_int_distribution<size_t> pick(0, comp.size() - 1);
+    for (size_t i = 0; i < NUM_SAMPLES; ++i)
+        counts[comp[pick(gen)]]++;
+
+    auto most = max_element(counts.begin(), counts.end(),
+                            [](const auto& a, const auto& b) { return a.second < b.second; });
+    fraction = static_cast<double>(most->second) / NUM_SAMPLES;
+    return most->first;
+}
+
+// afforest: link a few sampled neighbors per vertex, find the giant intermediate component,
+// then finish linking only from vertices outside it. assumes symmetric (undirected) adjacency.
+// progress counts edges settled by the finish phase, including those of skipped vertices
+template <typename VertexId>
+ComponentsResult connected_components_afforest(const BasicGraphCSR<VertexId>& graph, int num_threads, int neighbor_rounds,
+                                               ProgressControl* progress) 
+{
+    ThreadTeam team(num_threads);
+    int actual_threads = team.size();
+    PerfCounters counters(progress_wants_counters(progress), actual_threads);
+
+    auto start_time = high_resolution_clock::now();
+
+    TraceSpan kernel_span("afforest");
+    const size_t num_vertices = graph.num_vert;
+    const size_t rounds = neighbor_rounds > 0 ? neighbor_rounds : 0;
+    TraceSpan init_span("afforest.init");
+    vector<VertexId> comp(num_vertices);
     
-    // second pass: fill components
     #pragma omp parallel for
     for (size_t i = 0; i < num_vertices; ++i) 
     {
-        int root = parent[i];
-        components[root].push_back(i);
+        comp[i] = i;
     }
+    init_span.end();
 
-    // remove empty components
-    components.erase(
-        remove_if(components.begin(), components.end(),
-                 [](const vector<int>& v) { return v.empty(); }),
-        components.end());
-
-    auto end_time = high_resolution_clock::now();
-    auto duration = duration_cast<microseconds>(end_time - start_time);
-    double exec_time = duration.count() / 1000.0;
-
-    // generate output string
-    stringstream result;
-    result << "Optimized Parallel Connected Components\n";
-    result << "Graph size: " << num_vertices << " vertices\n";
-    result << "Number of threads: " << actual_threads << "\n";
-    
-    // count edges
-    size_t edge_count = 0;
-    for (size_t i = 0; i < num_vertices; ++i) 
+    // sampling phase: round r links every vertex with its r-th neighbor
+    progress_start(progress, graph.num_edges());
+    TraceSpan sample_span("afforest.sample");
+    for (size_t r = 0; r < rounds; ++r) 
     {
-        edge_count += graph.adjList[i].size();
+        throw_if_cancelled(progress);
+        #pragma omp parallel for schedule(dynamic, 16384)
+        for (size_t u = 0; u < num_vertices; ++u) 
+        {
+            uint64_t e = graph.offsets[u] + r;
+            if (e < graph.offsets[u + 1])
+                afforest_link<VertexId>(comp, u, graph.neighbors[e]);
+        }
+        afforest_compress(comp);
     }
-    edge_count /= 2;
-    result << "Number of edges: " << edge_count << "\n";
-    
-    result << "\nPerformance Metrics:\n";
-    result << "Execution time: " << fixed << setprecision(3) << exec_time << " ms\n";
-    result << "Number of components: " << components.size() << "\n";
-    
-    if (num_vertices <= 20) 
+
+    sample_span.end();
+
+    TraceSpan giant_span("afforest.giant");
+    double giant_fraction = 0.0;
+    VertexId giant = num_vertices > 0 ? afforest_sample_frequent(comp, giant_fraction) : 0;
+    giant_span.end();
+
+    // finish phase: vertices already in the giant component are skipped; their remaining
+    // edges are seen from the other endpoint because the adjacency is symmetric
+    size_t skipped_vertices = 0;
+    TraceSpan finish_span("afforest.finish");
+    #pragma omp parallel reduction(+:skipped_vertices)
     {
-        result << "\nComponents:\n";
-        for (size_t i = 0; i < components.size(); ++i) 
+        TraceSpan worker_span("afforest.finish_worker");
+        #pragma omp for schedule(dynamic, 1) nowait
+        for (size_t first = 0; first < num_vertices; first += CC_CHUNK) 
         {
-            result << "Component " << i << " (size " << components[i].size() << "): ";
-            for (int v : components[i]) 
+            if (progress_cancelled(progress))
+                continue;
+            size_t last = min(first + CC_CHUNK, num_vertices);
+            for (size_t u = first; u < last; ++u) 
             {
-                result << v << " ";
+                if (comp[u] == giant) 
+                {
+                    skipped_vertices++;
+                    continue;
+                }
+                for (uint64_t e = graph.offsets[u] + rounds; e < graph.offsets[u + 1]; ++e) 
+                {
+                    afforest_link<VertexId>(comp, u, graph.neighbors[e]);
+                }
             }
-            result << "\n";
+            progress_advance(progress, graph.offsets[last] - graph.offsets[first]);
         }
-    } else {
-        size_t max_size = 0;
-        for (const auto& comp : components) 
-        {
-            max_size = max(max_size, comp.size());
-        }
-        result << "Largest component size: " << max_size << "\n";
     }
+    finish_span.end();
+    throw_if_cancelled(progress);
+    TraceSpan compress_span("afforest.compress");
+    afforest_compress(comp);
+    compress_span.end();
+
+    ComponentList components = components_from_labels(comp);
+    kernel_span.end();
 
-    return make_pair(components, result.str());
+    auto end_time = high_resolution_clock::now();
+    RunStats stats;
+    stats.algorithm = "cc_afforest";
+    stats.num_vert = num_vertices;
+    stats.num_edges = graph.num_edges() / 2;
+    stats.threads = actual_threads;
+    stats.neighbor_rounds = static_cast<int>(rounds);
+    stats.giant_fraction = giant_fraction;
+    stats.skipped_vertices = skipped_vertices;
+    stats.counters = counters.stop();
+    stats.kernel_ms = duration_cast<microseconds>(end_time - start_time).count() / 1000.0;
+    stats.total_ms = stats.kernel_ms;
+    progress_kernel_time(progress, stats.kernel_ms);
+    progress_counters(progress, stats.counters);
+
+    return ComponentsResult{ move(components), move(stats) };
 }
 
-// parallel floyd-warshall
-pair<Matrix, string> floyd_algorithm_parallel(const GraphMatrix& graph, int num_threads = 0)
+template ComponentsResult connected_components_afforest<uint32_t>(const GraphCSR&, int, int, ProgressControl*);
+template ComponentsResult connected_components_afforest<uint64_t>(const GraphCSR64&, int, int, ProgressControl*);
+
+// parallel floyd-warshall; progress counts finished k iterations
+FloydResult floyd_algorithm_parallel(const GraphMatrix& graph, int num_threads, ProgressControl* progress)
 {
+    ThreadTeam team(num_threads);
+    int actual_threads = team.size();
+
     auto start_time = high_resolution_clock::now();
     
+    TraceSpan copy_span("floyd.copy");
     Matrix dist = graph.weight_matrix;
-    stringstream result;
-    
-    #ifdef _OPENMP
-    if (num_threads > 0) {
-        omp_set_num_threads(num_threads);
-    }
-    int actual_threads = omp_get_max_threads();
-    #else
-    int actual_threads = 1;
-    #endif
-    
-    result << "Optimized Parallel Floyd-Warshall Algorithm\n";
-    result << "Graph size: " << graph.num_vert << " vertices\n";
-    result << "Number of threads: " << actual_threads << "\n";
-    result << "Time complexity: O(V³) = O(" << graph.num_vert << "³) = O(" << 
-              (graph.num_vert * graph.num_vert * graph.num_vert) << ")\n\n";
-
-    // show initial matrix only for small graphs
-    if (graph.num_vert <= 20) 
-    {
-        result << "Initial distance matrix:\n";
-        for (const auto& row : dist) 
-        {
-            for (int val : row) 
-            {
-                if (val == INF)
-                    result << "∞ ";
-                else
-                    result << val << " ";
-            }
-            result << "\n";
-        }
-        result << "\n";
-    }
+    copy_span.end();
 
     // show only algorithm execution time
+    PerfCounters counters(progress_wants_counters(progress), actual_threads);
+    TraceSpan kernel_span("floyd.kernel");
     auto algorithm_start = high_resolution_clock::now();
     
+    MatrixView d = dist.view();
+    progress_start(progress, graph.num_vert);
     for(size_t k = 0; k < graph.num_vert; k++)
     {
+        throw_if_cancelled(progress);
+        const int* row_k = d[k];
+
+        // rows are contiguous, so each thread streams whole rows
         #ifdef _OPENMP
-        #pragma omp parallel for collapse(2) schedule(static)
+        #pragma omp parallel for schedule(static)
         #endif
         for(size_t i = 0; i < graph.num_vert; i++)
         {
-            for(size_t j = 0; j < graph.num_vert; j++)
-            {
-                if(dist[i][k] != INF && dist[k][j] != INF)
-                {
-                    int new_dist = dist[i][k] + dist[k][j];
-                    if(new_dist < dist[i][j])
-                    {
-                        dist[i][j] = new_dist;
-                    }
-                }
-            }
+            int* row_i = d[i];
+            const int d_ik = row_i[k];
+            if(d_ik == INF)
+                continue;
+
+            minplus_row(row_i, row_k, d_ik, graph.num_vert);
         }
+        progress_advance(progress, 1);
     }
     
     auto algorithm_end = high_resolution_clock::now();
-    auto end_time = high_resolution_clock::now();
-    
-    auto total_duration = duration_cast<microseconds>(end_time - start_time);
-    auto algorithm_duration = duration_cast<microseconds>(algorithm_end - algorithm_start);
-    
-    double total_time_ms = total_duration.count() / 1000.0;
-    double algorithm_time_ms = algorithm_duration.count() / 1000.0;
-    
-    // show final matrix only for small graphs
-    if (graph.num_vert <= 20) 
+    kernel_span.end();
+
+    RunStats stats;
+    stats.algorithm = "floyd_parallel";
+    stats.num_vert = graph.num_vert;
+    stats.threads = actual_threads;
+    stats.counters = counters.stop();
+    stats.kernel_ms = duration_cast<microseconds>(algorithm_end - algorithm_start).count() / 1000.0;
+    stats.total_ms = duration_cast<microseconds>(high_resolution_clock::now() - start_time).count() / 1000.0;
+    progress_kernel_time(progress, stats.kernel_ms);
+    progress_counters(progress, stats.counters);
+
+    return FloydResult{ move(dist), move(stats) };
+}
+
+// relax tile c through tile a (rows of c, k columns) and tile b (k rows, columns of c)
+// tiles may alias, as they do for the diagonal, row and column phases
+static void floyd_tile(MatrixView c, ConstMatrixView a, ConstMatrixView b)
+{
+    for(size_t k = 0; k < a.cols; k++)
     {
-        result << "Final shortest paths matrix:\n";
-        for (const auto& row : dist) 
+        const int* row_k = b[k];
+        for(size_t i = 0; i < c.rows; i++)
         {
-            for (int val : row) 
-            {
-                if (val == INF)
-                    result << "∞ ";
-                else
-                    result << val << " ";
-            }
-            result << "\n";
+            int* row_i = c[i];
+            const int d_ik = a[i][k];
+            if(d_ik == INF)
+                continue;
+
+            minplus_row(row_i, row_k, d_ik, c.cols);
         }
-        result << "\n";
     }
-    
-    result << string(50, '=') << "\n";
-    result << "PERFORMANCE BENCHMARK:\n";
-    result << string(50, '=') << "\n";
-    result << "Algorithm execution time: " << format_time(algorithm_time_ms) << "\n";
-    result << "Total time (including I/O): " << format_time(total_time_ms) << "\n";
-    result << "Operations performed: " << (graph.num_vert * graph.num_vert * graph.num_vert) << "\n";
-    if (algorithm_time_ms > 0) 
-    {
-        result << "Operations per second: " << fixed << setprecision(0) << 
-                  (graph.num_vert * graph.num_vert * graph.num_vert * 1000.0 / algorithm_time_ms) << "\n";
-    }
-    result << "Parallel efficiency: Good\n";
-    
-    return make_pair(dist, result.str());
 }
 
-// comparison
-pair<string, string> compare_algorithms(const GraphMatrix& matrix_graph, const GraphAdjList& list_graph, int num_threads = 4)
+// blocked (tiled) parallel floyd-warshall; progress counts k iterations, a tile row at a time
+FloydResult floyd_algorithm_blocked(const GraphMatrix& graph, int num_threads, size_t tile_size,
+                                    ProgressControl* progress)
 {
-    stringstream comparison;
-    comparison << "PERFORMANCE COMPARISON: Sequential vs Parallel\n";
-    comparison << string(60, '=') << "\n\n";
-    
-    // compare floyd-warshall
-    comparison << "FLOYD-WARSHALL ALGORITHM COMPARISON:\n";
-    comparison << string(40, '-') << "\n";
-    
-    auto floyd_seq_start = high_resolution_clock::now();
-    auto floyd_seq = floyd_algorithm(matrix_graph);
-    auto floyd_seq_end = high_resolution_clock::now();
-    auto floyd_seq_time = duration_cast<microseconds>(floyd_seq_end - floyd_seq_start).count() / 1000.0;
-    
-    auto floyd_par_start = high_resolution_clock::now();
-    auto floyd_par = floyd_algorithm_parallel(matrix_graph, num_threads);
-    auto floyd_par_end = high_resolution_clock::now();
-    auto floyd_par_time = duration_cast<microseconds>(floyd_par_end - floyd_par_start).count() / 1000.0;
-    
-    comparison << "Sequential Floyd-Warshall: " << format_time(floyd_seq_time) << "\n";
-    comparison << "Parallel Floyd-Warshall (" << num_threads << " threads): " << format_time(floyd_par_time) << "\n";
-    
-    if (floyd_seq_time > 0 && floyd_par_time > 0) 
-    {
-        double floyd_speedup = floyd_seq_time / floyd_par_time;
-        double floyd_efficiency = floyd_speedup / num_threads * 100.0;
-        comparison << "Floyd Speedup: " << fixed << setprecision(2) << floyd_speedup << "x\n";
-        comparison << "Floyd Efficiency: " << fixed << setprecision(1) << floyd_efficiency << "%\n";
-    }
-    
-    comparison << "\n";
+    ThreadTeam team(num_threads);
+    int actual_threads = team.size();
 
-    // compare connected components
-    comparison << "CONNECTED COMPONENTS ALGORITHM COMPARISON:\n";
-    comparison << string(40, '-') << "\n";
-    
-    auto cc_seq_start = high_resolution_clock::now();
-    auto cc_seq = connected_components_algorithm(list_graph);
-    auto cc_seq_end = high_resolution_clock::now();
-    auto cc_seq_time = duration_cast<microseconds>(cc_seq_end - cc_seq_start).count() / 1000.0;
-    
-    auto cc_par_start = high_resolution_clock::now();
-    auto cc_par = connected_components_algorithm_parallel(list_graph, num_threads);
-    auto cc_par_end = high_resolution_clock::now();
-    auto cc_par_time = duration_cast<microseconds>(cc_par_end - cc_par_start).count() / 1000.0;
-    
-    comparison << "Sequential Connected Components: " << format_time(cc_seq_time) << "\n";
-    comparison << "Parallel Connected Components (" << num_threads << " threads): " << format_time(cc_par_time) << "\n";
+    auto start_time = high_resolution_clock::now();
     
-    if (cc_seq_time > 0 && cc_par_time > 0) 
+    TraceSpan copy_span("floyd.copy");
+    Matrix dist = graph.weight_matrix;
+    copy_span.end();
+
+    const size_t n = graph.num_vert;
+    if (tile_size == 0)
+        tile_size = DEFAULT_FLOYD_TILE_SIZE;
+    tile_size = min(tile_size, max<size_t>(n, 1));
+    const size_t num_tiles = (n + tile_size - 1) / tile_size;
+
+    PerfCounters counters(progress_wants_counters(progress), actual_threads);
+    TraceSpan kernel_span("floyd.kernel");
+    auto algorithm_start = high_resolution_clock::now();
+
+    MatrixView d = dist.view();
+    auto tile = [&](size_t ti, size_t tj) {
+        size_t row = ti * tile_size;
+        size_t col = tj * tile_size;
+        return d.block(row, col, min(tile_size, n - row), min(tile_size, n - col));
+    };
+
+    progress_start(progress, n);
+    for(size_t kb = 0; kb < num_tiles; kb++)
     {
-        double cc_speedup = cc_seq_time / cc_par_time;
-        double cc_efficiency = cc_speedup / num_threads * 100.0;
-        comparison << "Connected Components Speedup: " << fixed << setprecision(2) << cc_speedup << "x\n";
-        comparison << "Connected Components Efficiency: " << fixed << setprecision(1) << cc_efficiency << "%\n";
-    }
-    
-    comparison << "\n" << string(60, '=') << "\n";
-    comparison << "SUMMARY:\n";
-    comparison << "Graph size: " << matrix_graph.num_vert << " vertices\n";
-    comparison << "Threads used: " << num_threads << "\n";
-    
-    #ifdef _OPENMP
-    comparison << "OpenMP: Enabled\n";
-    comparison << "Max threads available: " << omp_get_max_threads() << "\n";
-    #else
-    comparison << "OpenMP: Not available (sequential execution)\n";
-    #endif
-    
-    return make_pair(comparison.str(), floyd_par.second + "\n\n" + cc_par.second);
-}
+        throw_if_cancelled(progress);
 
-int main() 
-{
-    httplib::Server svr;
-
-    svr.set_mount_point("/", "./web");
-
-    svr.set_pre_routing_handler([](const httplib::Request& req, httplib::Response& res) {
-        res.set_header("Access-Control-Allow-Origin", "*");
-        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
-        return httplib::Server::HandlerResponse::Unhandled;
-    });
-
-    svr.Options(".*", [](const httplib::Request&, httplib::Response& res) {
-        return;
-    });
-
-    // API
-    svr.Post("/generate", [](const httplib::Request& req, httplib::Response& res) {
-        try {
-            auto j = json::parse(req.body);
-
-            size_t num_vert = j.at("num_vert").get<size_t>();
-            size_t num_edges = j.at("num_edges").get<size_t>();
-            int max_weight = j.at("max_weight").get<int>();
-            bool is_directed = j.at("is_directed").get<bool>();
-            int graph_type = j.at("graph_type").get<int>();
-
-            json response_json;
-
-            if (graph_type == 0) {
-                GraphMatrix g = generate_random_graph_matrix(num_vert, max_weight, num_edges, is_directed);
-                
-                if (!g.valid) {
-                    res.status = 400;
-                    res.set_content("Error: Invalid graph parameters", "text/plain");
-                    return;
-                }
-                
-                json matrix_json = json::array();
-                for (const auto& row : g.weight_matrix) {
-                    json row_json = json::array();
-                    for (int val : row) {
-                        if (val == INF) {
-                            row_json.push_back(json(nullptr));
-                        } else {
-                            row_json.push_back(val);
-                        }
-                    }
-                    matrix_json.push_back(row_json);
-                }
-                response_json["matrix"] = matrix_json;
-            } else {
-                GraphAdjList g = generate_random_graph_list(num_vert, max_weight, num_edges, is_directed);
-                
-                if (!g.valid) {
-                    res.status = 400;
-                    res.set_content("Error: Invalid graph parameters", "text/plain");
-                    return;
-                }
-                
-                json list_json = json::array();
-                for (const auto& adj : g.adjList) {
-                    json adj_json = json::array();
-                    for (const auto& neighbor : adj) {
-                        adj_json.push_back({{"to", neighbor.first}, {"weight", neighbor.second}});
-                    }
-                    list_json.push_back(adj_json);
-                }
-                response_json["adjList"] = list_json;
-            }
+        // phase 1: the diagonal tile depends only on itself
+        TraceSpan diagonal_span("floyd_blocked.diagonal");
+        MatrixView diag = tile(kb, kb);
+        floyd_tile(diag, diag, diag);
+        diagonal_span.end();
 
-            res.set_content(response_json.dump(4), "application/json");
-        } catch (const std::exception& e) {
-            res.status = 400;
-            res.set_content(std::string("Error: ") + e.what(), "text/plain");
-        }
-    });
-
-    svr.Post("/create_custom", [](const httplib::Request& req, httplib::Response& res) {
-        try {
-            auto j = json::parse(req.body);
-            
-            size_t num_vert = j.at("num_vert").get<size_t>();
-            bool is_directed = j.at("is_directed").get<bool>();
-            int graph_type = j.at("graph_type").get<int>();
-            auto edges = j.at("edges");
-
-            json response_json;
-
-            if (graph_type == 0) {
-                GraphMatrix g(num_vert);
-                
-                for (const auto& edge : edges) {
-                    size_t from = edge.at("from").get<size_t>();
-                    size_t to = edge.at("to").get<size_t>();
-                    int weight = edge.at("weight").get<int>();
-                    
-                    if (from >= num_vert || to >= num_vert) {
-                        res.status = 400;
-                        res.set_content("Error: Vertex index out of range", "text/plain");
-                        return;
-                    }
-                    
-                    add_edge_matrix(g, from, to, weight, 0, is_directed);
-                }
-                
-                json matrix_json = json::array();
-                for (const auto& row : g.weight_matrix) {
-                    json row_json = json::array();
-                    for (int val : row) {
-                        if (val == INF) {
-                            row_json.push_back(json(nullptr));
-                        } else {
-                            row_json.push_back(val);
-                        }
-                    }
-                    matrix_json.push_back(row_json);
-                }
-                response_json["matrix"] = matrix_json;
-            } else {
-                GraphAdjList g(num_vert);
-                
-                for (const auto& edge : edges) {
-                    size_t from = edge.at("from").get<size_t>();
-                    size_t to = edge.at("to").get<size_t>();
-                    int weight = edge.at("weight").get<int>();
-                    
-                    if (from >= num_vert || to >= num_vert) {
-                        res.status = 400;
-                        res.set_content("Error: Vertex index out of range", "text/plain");
-                        return;
-                    }
-                    
-                    add_edge_adjList(g, from, to, weight, 0, is_directed);
-                }
-                
-                json list_json = json::array();
-                for (const auto& adj : g.adjList) {
-                    json adj_json = json::array();
-                    for (const auto& neighbor : adj) {
-                        adj_json.push_back({{"to", neighbor.first}, {"weight", neighbor.second}});
-                    }
-                    list_json.push_back(adj_json);
-                }
-                response_json["adjList"] = list_json;
-            }
+        // phase 2: tiles in row kb and column kb depend on themselves and the diagonal tile
+        TraceSpan cross_span("floyd_blocked.row_column");
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 1)
+        #endif
+        for(size_t t = 0; t < 2 * num_tiles; t++)
+        {
+            size_t other = t / 2;
+            if(other == kb)
+                continue;
 
-            res.set_content(response_json.dump(4), "application/json");
-        } catch (const std::exception& e) {
-            res.status = 400;
-            res.set_content(std::string("Error: ") + e.what(), "text/plain");
-        }
-    });
-
-    // API for floyd-warshall
-    svr.Post("/floyd", [](const httplib::Request& req, httplib::Response& res) {
-        try {
-            auto j = json::parse(req.body);
-            
-            if (j.find("matrix") == j.end()) {
-                res.status = 400;
-                res.set_content("Error: Matrix data required for Floyd algorithm", "text/plain");
-                return;
+            if(t % 2 == 0)
+            {
+                MatrixView row_tile = tile(kb, other);
+                floyd_tile(row_tile, diag, row_tile);
+            }
+            else
+            {
+                MatrixView col_tile = tile(other, kb);
+                floyd_tile(col_tile, col_tile, diag);
             }
+        }
 
-            auto matrix_data = j.at("matrix");
-            size_t num_vert = matrix_data.size();
-            GraphMatrix graph(num_vert);
+        cross_span.end();
 
-            for (size_t i = 0; i < num_vert; i++) {
-                for (size_t j = 0; j < num_vert; j++) {
-                    if (matrix_data[i][j].is_null()) {
-                        graph.weight_matrix[i][j] = INF;
-                    } else {
-                        graph.weight_matrix[i][j] = matrix_data[i][j].get<int>();
-                    }
-                }
+        // phase 3: every remaining tile only reads its row and column tiles
+        TraceSpan rest_span("floyd_blocked.remaining");
+        #ifdef _OPENMP
+        #pragma omp parallel for collapse(2) schedule(static)
+        #endif
+        for(size_t ib = 0; ib < num_tiles; ib++)
+        {
+            for(size_t jb = 0; jb < num_tiles; jb++)
+            {
+                if(ib == kb || jb == kb)
+                    continue;
+                floyd_tile(tile(ib, jb), tile(ib, kb), tile(kb, jb));
             }
+        }
+        progress_advance(progress, diag.rows);
+    }
 
-            auto result = floyd_algorithm(graph);
-            json response_json;
-            response_json["result"] = result.second;
+    auto algorithm_end = high_resolution_clock::now();
+    kernel_span.end();
+
+    RunStats stats;
+    stats.algorithm = "floyd_blocked";
+    stats.num_vert = n;
+    stats.threads = actual_threads;
+    stats.tile_size = tile_size;
+    stats.counters = counters.stop();
+    stats.kernel_ms = duration_cast<microseconds>(algorithm_end - algorithm_start).count() / 1000.0;
+    stats.total_ms = duration_cast<microseconds>(high_resolution_clock::now() - start_time).count() / 1000.0;
+    progress_kernel_time(progress, stats.kernel_ms);
+    progress_counters(progress, stats.counters);
+
+    return FloydResult{ move(dist), move(stats) };
+}
 
-            res.set_content(response_json.dump(4), "application/json");
-        } catch (const std::exception& e) {
-            res.status = 400;
-            res.set_content(std::string("Error: ") + e.what(), "text/plain");
-        }
-    });
-
-    // API for connected components (sequential)
-    svr.Post("/connected_components", [](const httplib::Request& req, httplib::Response& res) {
-        try {
-            auto j = json::parse(req.body);
-            
-            GraphAdjList graph;
-            
-            if (j.find("adjList") != j.end()) {
-                auto list_data = j.at("adjList");
-                graph = GraphAdjList(list_data.size());
-                
-                for (size_t i = 0; i < list_data.size(); i++) {
-                    for (const auto& neighbor : list_data[i]) {
-                        size_t to = neighbor.at("to").get<size_t>();
-                        int weight = neighbor.at("weight").get<int>();
-                        graph.adjList[i].push_back(make_pair(to, weight));
-                    }
-                }
-            } else if (j.find("matrix") != j.end()) {
-                auto matrix_data = j.at("matrix");
-                size_t num_vert = matrix_data.size();
-                GraphMatrix temp_graph(num_vert);
-                
-                for (size_t i = 0; i < num_vert; i++) {
-                    for (size_t j = 0; j < num_vert; j++) {
-                        if (!matrix_data[i][j].is_null()) {
-                            temp_graph.weight_matrix[i][j] = matrix_data[i][j].get<int>();
-                        }
-                    }
-                }
-                
-                graph = matrix_to_list(temp_graph);
-            } else {
-                res.status = 400;
-                res.set_content("Error: Graph data required for Connected Components algorithm", "text/plain");
-                return;
-            }
+// comparison
+pair<string, string> compare_algorithms(const GraphMatrix& matrix_graph, const GraphAdjList& list_graph, int num_threads,
+                                        size_t tile_size, int warmup, int trials, vector<VariantTiming>* timings)
+{
+    return compare_algorithms(matrix_graph, list_to_csr(list_graph), num_threads, tile_size, warmup, trials, timings);
+}
 
-            auto result = connected_components_algorithm(graph);
-            json response_json;
-            response_json["components"] = result.first;
-            response_json["result"] = result.second;
+// untimed warmup runs, then trials timed by the kernel time each run reports; keeps the last result
+template <typename Run>
+static TimingSummary time_kernel(Run run, int warmup, int trials, decltype(run(nullptr))& last)
+{
+    for (int w = 0; w < warmup; w++)
+        run(nullptr);
 
-            res.set_content(response_json.dump(4), "application/json");
-        } catch (const std::exception& e) {
-            res.status = 400;
-            res.set_content(std::string("Error: ") + e.what(), "text/plain");
-        }
-    });
-
-    // API for parallel connected components
-    svr.Post("/connected_components_parallel", [](const httplib::Request& req, httplib::Response& res) {
-        try {
-            auto j = json::parse(req.body);
-            
-            GraphAdjList graph;
-            
-            if (j.find("adjList") != j.end()) {
-                auto list_data = j.at("adjList");
-                graph = GraphAdjList(list_data.size());
-                
-                for (size_t i = 0; i < list_data.size(); i++) {
-                    for (const auto& neighbor : list_data[i]) {
-                        size_t to = neighbor.at("to").get<size_t>();
-                        int weight = neighbor.at("weight").get<int>();
-                        graph.adjList[i].push_back(make_pair(to, weight));
-                    }
-                }
-            } else if (j.find("matrix") != j.end()) {
-                auto matrix_data = j.at("matrix");
-                size_t num_vert = matrix_data.size();
-                GraphMatrix temp_graph(num_vert);
-                
-                for (size_t i = 0; i < num_vert; i++) {
-                    for (size_t j = 0; j < num_vert; j++) {
-                        if (!matrix_data[i][j].is_null()) {
-                            temp_graph.weight_matrix[i][j] = matrix_data[i][j].get<int>();
-                        }
-                    }
-                }
-                
-                graph = matrix_to_list(temp_graph);
-            } else {
-                res.status = 400;
-                res.set_content("Error: Graph data required for Connected Components algorithm", "text/plain");
-                return;
-            }
+    vector<double> times_ms;
+    for (int t = 0; t < trials; t++)
+    {
+        ProgressControl control;
+        last = run(&control);
+        times_ms.push_back(control.kernel_ms.load());
+    }
+    return summarize_timings(times_ms);
+}
 
-            int num_threads = 4; // default
-            if (j.find("num_threads") != j.end()) {
-                num_threads = j.at("num_threads").get<int>();
-            }
+// vertex -> smallest vertex of its component, so partitions compare regardless of component order
+static vector<int> component_of(const ComponentList& components, size_t num_vert)
+{
+    vector<int> smallest(num_vert, -1);
+    for (size_t c = 0; c < components.size(); ++c)
+    {
+        int first = *min_element(components[c].begin(), components[c].end());
+        for (int v : components[c])
+            smallest[v] = first;
+    }
+    return smallest;
+}
 
-            auto result = connected_components_algorithm_parallel(graph, num_threads);
-            json response_json;
-            response_json["components"] = result.first;
-            response_json["result"] = result.second;
+static VariantTiming variant_timing(const string& name, int threads, const TimingSummary& kernel,
+                                    const TimingSummary& sequential, bool matches)
+{
+    VariantTiming timing{ name, threads, kernel, matches, 0.0, 0.0, 0.0, 0.0 };
+    if (kernel.median_ms > 0 && kernel.median_low_ms > 0)
+    {
+        timing.speedup = sequential.median_ms / kernel.median_ms;
+        timing.speedup_low = sequential.median_low_ms / kernel.median_high_ms;
+        timing.speedup_high = sequential.median_high_ms / kernel.median_low_ms;
+        timing.efficiency = timing.speedup / threads;
+    }
+    return timing;
+}
 
-            res.set_content(response_json.dump(4), "application/json");
-        } catch (const std::exception& e) {
-            res.status = 400;
-            res.set_content(std::string("Error: ") + e.what(), "text/plain");
-        }
-    });
-
-    // API for parallel floyd-warshall
-    svr.Post("/floyd_parallel", [](const httplib::Request& req, httplib::Response& res) {
-        try {
-            auto j = json::parse(req.body);
-            
-            if (j.find("matrix") == j.end()) {
-                res.status = 400;
-                res.set_content("Error: Matrix data required for Floyd algorithm", "text/plain");
-                return;
-            }
+static void write_timing(stringstream& out, const string& label, const TimingSummary& kernel)
+{
+    out << label << ": " << format_time(kernel.median_ms) << "  [95% CI " << format_time(kernel.median_low_ms)
+        << " - " << format_time(kernel.median_high_ms) << "]\n";
+}
 
-            auto matrix_data = j.at("matrix");
-            size_t num_vert = matrix_data.size();
-            GraphMatrix graph(num_vert);
+static void write_speedup(stringstream& out, const string& label, const VariantTiming& timing)
+{
+    write_timing(out, label + " (" + to_string(timing.threads) + " threads)", timing.kernel);
+    out << "  Results match sequential: " << (timing.matches_sequential ? "yes" : "NO") << "\n";
+    if (timing.speedup > 0)
+    {
+        out << "  Speedup: " << fixed << setprecision(2) << timing.speedup << "x  [" << timing.speedup_low
+            << "x - " << timing.speedup_high << "x]\n";
+        out << "  Efficiency: " << fixed << setprecision(1) << timing.efficiency * 100.0 << "%\n";
+    }
+}
 
-            for (size_t i = 0; i < num_vert; i++) {
-                for (size_t j = 0; j < num_vert; j++) {
-                    if (matrix_data[i][j].is_null()) {
-                        graph.weight_matrix[i][j] = INF;
-                    } else {
-                        graph.weight_matrix[i][j] = matrix_data[i][j].get<int>();
-                    }
-                }
-            }
+pair<string, string> compare_algorithms(const GraphMatrix& matrix_graph, const GraphCSR& csr_graph, int num_threads,
+                                        size_t tile_size, int warmup, int trials, vector<VariantTiming>* timings)
+{
+    if (warmup < 0 || trials < 1)
+        throw invalid_argument("compare_algorithms needs warmup >= 0 and trials >= 1");
 
-            int num_threads = 4; // default
-            if (j.find("num_threads") != j.end()) {
-                num_threads = j.at("num_threads").get<int>();
-            }
+    // the team the parallel variants actually get, for efficiency
+    const int threads = thread_budget().team_size(num_threads);
+    vector<VariantTiming> variants;
 
-            auto result = floyd_algorithm_parallel(graph, num_threads);
-            json response_json;
-            response_json["result"] = result.second;
+    stringstream comparison;
+    comparison << "PERFORMANCE COMPARISON: Sequential vs Parallel\n";
+    comparison << string(60, '=') << "\n";
+    comparison << "Median kernel time of " << trials << " trials after " << warmup << " warmup runs; "
+               << "reports and input copies are not timed\n\n";
 
-            res.set_content(response_json.dump(4), "application/json");
-        } catch (const std::exception& e) {
-            res.status = 400;
-            res.set_content(std::string("Error: ") + e.what(), "text/plain");
-        }
-    });
-
-    // API for comparison
-    svr.Post("/compare", [](const httplib::Request& req, httplib::Response& res) {
-        try {
-            auto j = json::parse(req.body);
-            
-            GraphMatrix matrix_graph;
-            GraphAdjList list_graph;
-            
-            if (j.find("matrix") != j.end()) {
-                auto matrix_data = j.at("matrix");
-                size_t num_vert = matrix_data.size();
-                matrix_graph = GraphMatrix(num_vert);
-                
-                for (size_t i = 0; i < num_vert; i++) {
-                    for (size_t j = 0; j < num_vert; j++) {
-                        if (matrix_data[i][j].is_null()) {
-                            matrix_graph.weight_matrix[i][j] = INF;
-                        } else {
-                            matrix_graph.weight_matrix[i][j] = matrix_data[i][j].get<int>();
-                        }
-                    }
-                }
-                
-                list_graph = matrix_to_list(matrix_graph);
-            } else if (j.find("adjList") != j.end()) {
-                auto list_data = j.at("adjList");
-                list_graph = GraphAdjList(list_data.size());
-                
-                for (size_t i = 0; i < list_data.size(); i++) {
-                    for (const auto& neighbor : list_data[i]) {
-                        size_t to = neighbor.at("to").get<size_t>();
-                        int weight = neighbor.at("weight").get<int>();
-                        list_graph.adjList[i].push_back(make_pair(to, weight));
-                    }
-                }
-                
-                matrix_graph = list_to_matrix(list_graph);
-            } else {
-                res.status = 400;
-                res.set_content("Error: Graph data required for comparison", "text/plain");
-                return;
-            }
+    // compare floyd-warshall
+    comparison << "FLOYD-WARSHALL ALGORITHM COMPARISON:\n";
+    comparison << string(40, '-') << "\n";
 
-            int num_threads = 4; // default
-            if (j.find("num_threads") != j.end()) {
-                num_threads = j.at("num_threads").get<int>();
-            }
+    FloydResult floyd_seq, floyd_par, floyd_blk;
+    TimingSummary floyd_seq_time = time_kernel([&](ProgressControl* p) { return floyd_algorithm(matrix_graph, p); },
+                                               warmup, trials, floyd_seq);
+    TimingSummary floyd_par_time = time_kernel([&](ProgressControl* p) {
+        return floyd_algorithm_parallel(matrix_graph, num_threads, p);
+    }, warmup, trials, floyd_par);
+    TimingSummary floyd_blk_time = time_kernel([&](ProgressControl* p) {
+        return floyd_algorithm_blocked(matrix_graph, num_threads, tile_size, p);
+    }, warmup, trials, floyd_blk);
+
+    variants.push_back(variant_timing("floyd_parallel", threads, floyd_par_time, floyd_seq_time,
+                                      floyd_par.dist == floyd_seq.dist));
+    variants.push_back(variant_timing("floyd_blocked", threads, floyd_blk_time, floyd_seq_time,
+                                      floyd_blk.dist == floyd_seq.dist));
+
+    write_timing(comparison, "Sequential Floyd-Warshall", floyd_seq_time);
+    write_speedup(comparison, "Parallel Floyd-Warshall", variants[0]);
+    write_speedup(comparison, "Blocked Floyd-Warshall", variants[1]);
+    comparison << "\n";
 
-            auto result = compare_algorithms(matrix_graph, list_graph, num_threads);
-            json response_json;
-            response_json["comparison"] = result.first;
-            response_json["detailed_results"] = result.second;
+    // compare connected components
+    comparison << "CONNECTED COMPONENTS ALGORITHM COMPARISON:\n";
+    comparison << string(40, '-') << "\n";
 
-            res.set_content(response_json.dump(4), "application/json");
-        } catch (const std::exception& e) {
-            res.status = 400;
-            res.set_content(std::string("Error: ") + e.what(), "text/plain");
-        }
-    });
+    ComponentsResult cc_seq, cc_par, cc_aff;
+    TimingSummary cc_seq_time = time_kernel([&](ProgressControl* p) {
+        return connected_components_algorithm(csr_graph, p);
+    }, warmup, trials, cc_seq);
+    TimingSummary cc_par_time = time_kernel([&](ProgressControl* p) {
+        return connected_components_algorithm_parallel(csr_graph, num_threads, p);
+    }, warmup, trials, cc_par);
+    TimingSummary cc_aff_time = time_kernel([&](ProgressControl* p) {
+        return connected_components_afforest(csr_graph, num_threads, 2, p);
+    }, warmup, trials, cc_aff);
+
+    vector<int> cc_expected = component_of(cc_seq.components, csr_graph.num_vert);
+    variants.push_back(variant_timing("connected_components_parallel", threads, cc_par_time, cc_seq_time,
+                                      component_of(cc_par.components, csr_graph.num_vert) == cc_expected));
+    variants.push_back(variant_timing("connected_components_afforest", threads, cc_aff_time, cc_seq_time,
+                                      component_of(cc_aff.components, csr_graph.num_vert) == cc_expected));
+
+    write_timing(comparison, "Sequential Connected Components", cc_seq_time);
+    write_speedup(comparison, "Parallel Connected Components", variants[2]);
+    write_speedup(comparison, "Afforest Connected Components", variants[3]);
+
+    // compare single source shortest paths from vertex 0, which need non-negative weights
+    SsspResult sssp_seq, sssp_par;
+    bool has_sssp = csr_graph.num_vert > 0 &&
+                    none_of(csr_graph.weights.begin(), csr_graph.weights.end(), [](int w) { return w < 0; });
+    if (has_sssp)
+    {
+        comparison << "\nSINGLE SOURCE SHORTEST PATHS COMPARISON:\n";
+        comparison << string(40, '-') << "\n";
+
+        const vector<size_t> sources = { 0 };
+        TimingSummary sssp_seq_time = time_kernel([&](ProgressControl* p) {
+            return dijkstra_sssp(csr_graph, sources, p);
+        }, warmup, trials, sssp_seq);
+        TimingSummary sssp_par_time = time_kernel([&](ProgressControl* p) {
+            return delta_stepping_sssp(csr_graph, sources, num_threads, 0, p);
+        }, warmup, trials, sssp_par);
+
+        variants.push_back(variant_timing("sssp_delta_stepping", threads, sssp_par_time, sssp_seq_time,
+                                          sssp_par.dist == sssp_seq.dist));
+
+        write_timing(comparison, "Sequential Dijkstra", sssp_seq_time);
+        write_speedup(comparison, "Delta-Stepping", variants[4]);
+    }
 
-    std::cout << "Server started at http://localhost:8080\n";
-    std::cout << "Open http://localhost:8080 in your browser\n";
-    svr.listen("0.0.0.0", 8080);
+    comparison << "\n" << string(60, '=') << "\n";
+    comparison << "SUMMARY:\n";
+    comparison << "Graph size: " << matrix_graph.num_vert << " vertices\n";
+    comparison << "Threads used: " << threads << "\n";
+    comparison << "Floyd SIMD kernel: " << simd_isa_name(detect_simd_isa()) << "\n";
+    
+    #ifdef _OPENMP
+    comparison << "OpenMP: Enabled\n";
+    comparison << "Compute thread budget: " << thread_budget().capacity() << "\n";
+    #else
+    comparison << "OpenMP: Not available (sequential execution)\n";
+    #endif
 
-    return 0;
-}
\ No newline at end of file
+    if (timings)
+        *timings = variants;
+    // only the runs kept for the details are ever formatted
+    string details = floyd_report(matrix_graph, floyd_par) + "\n\n" + floyd_report(matrix_graph, floyd_blk) + "\n\n" +
+                     components_report(cc_par) + "\n\n" + components_report(cc_aff);
+    if (has_sssp)
+        details += "\n\n" + sssp_report(sssp_par);
+    return make_pair(comparison.str(), details);
+}
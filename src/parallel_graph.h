@@ -1,16 +1,64 @@
 #pragma once
 
 #include "graph.h"
+#include "bench_stats.h"
 #include <vector>
 #include <utility>
 #include <string>
 #include <atomic>
 
-std::pair<std::vector<std::vector<int>>, std::string> 
-connected_components_algorithm_parallel(const GraphAdjList& graph, int num_threads = 0);
+ComponentsResult connected_components_algorithm_parallel(const GraphAdjList& graph, int num_threads = 0);
 
-std::pair<Matrix, std::string> 
-floyd_algorithm_parallel(const GraphMatrix& graph, int num_threads = 0);
+template <typename VertexId>
+ComponentsResult 
+connected_components_algorithm_parallel(const BasicGraphCSR<VertexId>& graph, int num_threads = 0,
+                                        ProgressControl* progress = nullptr);
+
+// afforest (sampling + giant component skipping) connected components for symmetric graphs
+template <typename VertexId>
+ComponentsResult 
+connected_components_afforest(const BasicGraphCSR<VertexId>& graph, int num_threads = 0, int neighbor_rounds = 2,
+                              ProgressControl* progress = nullptr);
+
+// groups vertices by label; labels[v] is the representative vertex of v's component and
+// representatives label themselves. components come out ordered by representative, vertices ascending
+template <typename VertexId>
+ComponentList components_from_labels(const std::vector<VertexId>& labels);
+
+FloydResult 
+floyd_algorithm_parallel(const GraphMatrix& graph, int num_threads = 0, ProgressControl* progress = nullptr);
+
+// tile edge used by the blocked floyd-warshall when none is given; three int tiles fit in L2
+const size_t DEFAULT_FLOYD_TILE_SIZE = 64;
+
+FloydResult 
+floyd_algorithm_blocked(const GraphMatrix& graph, int num_threads = 0, size_t tile_size = DEFAULT_FLOYD_TILE_SIZE,
+                        ProgressControl* progress = nullptr);
+
+// one parallel variant in compare_algorithms, against its sequential counterpart. speedup bounds
+// combine the confidence intervals of both medians; efficiency divides by the team size
+struct VariantTiming
+{
+    std::string name;
+    int threads;
+    TimingSummary kernel;
+    bool matches_sequential;
+    double speedup;
+    double speedup_low;
+    double speedup_high;
+    double efficiency;
+};
+
+// every variant gets warmup untimed runs and trials timed runs of its kernel alone (see
+// ProgressControl::kernel_ms); parallel results are checked against the sequential ones.
+// returns the comparison and the reports of the last parallel runs, formatted once at the end.
+// shortest paths from vertex 0 are only compared when no weight is negative
+std::pair<std::string, std::string> 
+compare_algorithms(const GraphMatrix& matrix_graph, const GraphAdjList& list_graph, int num_threads = 4,
+                   size_t tile_size = DEFAULT_FLOYD_TILE_SIZE, int warmup = 1, int trials = 5,
+                   std::vector<VariantTiming>* timings = nullptr);
 
 std::pair<std::string, std::string> 
-compare_algorithms(const GraphMatrix& matrix_graph, const GraphAdjList& list_graph, int num_threads = 4);
\ No newline at end of file
+compare_algorithms(const GraphMatrix& matrix_graph, const GraphCSR& csr_graph, int num_threads = 4,
+                   size_t tile_size = DEFAULT_FLOYD_TILE_SIZE, int warmup = 1, int trials = 5,
+                   std::vector<VariantTiming>* timings = nullptr);
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "perf_counters.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+const char* perf_event_name(PerfEvent event)
+{
+    switch (event) {
+    case PERF_CYCLES: return "cycles";
+    case PERF_INSTRUCTIONS: return "instructions";
+    case PERF_LLC_MISSES: return "llc_misses";
+    case PERF_DTLB_MISSES: return "dtlb_misses";
+    case PERF_BRANCH_MISSES: return "branch_misses";
+    default: return "unknown";
+    }
+}
+
+#ifdef __linux__
+
+static void event_attr(PerfEvent event, perf_event_attr& attr)
+{
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (event) {
+    case PERF_CYCLES: attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+    case PERF_INSTRUCTIONS: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+    case PERF_BRANCH_MISSES: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+    case PERF_LLC_MISSES:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    default:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    }
+    // user space only, which perf_event_paranoid <= 2 allows without privileges
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+}
+
+// counters for the calling thread; the first failure is kept as the reason
+static void open_thread_counters(int* thread_fds, string& reason)
+{
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        perf_event_attr attr;
+        event_attr(static_cast<PerfEvent>(e), attr);
+        thread_fds[e] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+        if (thread_fds[e] < 0 && reason.empty()) {
+            int error = errno;
+            reason = string("perf_event_open(") + perf_event_name(static_cast<PerfEvent>(e)) + "): " + strerror(error);
+            if (error == EACCES || error == EPERM)
+                reason += " (see /proc/sys/kernel/perf_event_paranoid)";
+            else if (error == ENOENT || error == EOPNOTSUPP)
+                reason += " (no hardware counters, e.g. inside a VM)";
+        }
+    }
+}
+
+PerfCounters::PerfCounters(bool enabled, int threads)
+    : enabled(enabled), threads(threads < 1 ? 1 : threads)
+{
+    if (!enabled)
+        return;
+
+    fds.assign(static_cast<size_t>(this->threads) * PERF_EVENT_COUNT, -1);
+    vector<string> reasons(this->threads);
+    if (this->threads == 1) {
+        open_thread_counters(fds.data(), reasons[0]);
+    } else {
+        #pragma omp parallel num_threads(this->threads)
+        {
+#ifdef _OPENMP
+            int t = omp_get_thread_num();
+#else
+            int t = 0;
+#endif
+            open_thread_counters(fds.data() + static_cast<size_t>(t) * PERF_EVENT_COUNT, reasons[t]);
+        }
+    }
+    for (const string& r : reasons)
+        if (reason.empty()) reason = r;
+}
+
+PerfCounters::~PerfCounters()
+{
+    for (int fd : fds)
+        if (fd >= 0) close(fd);
+}
+
+PerfCounts PerfCounters::stop()
+{
+    PerfCounts counts;
+    counts.collected = enabled;
+    counts.threads = threads;
+    if (!enabled)
+        return counts;
+
+    for (int fd : fds)
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    // an event counts only when every thread counted it, so the sums cover the whole team
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        bool complete = true;
+        double sum = 0;
+        for (int t = 0; t < threads && complete; t++) {
+            int fd = fds[static_cast<size_t>(t) * PERF_EVENT_COUNT + e];
+            uint64_t data[3]; // value, time enabled, time running
+            if (fd < 0 || read(fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+                complete = false;
+                break;
+            }
+            if (data[2] > 0)
+                sum += static_cast<double>(data[0]) * data[1] / data[2];
+            else if (data[1] > 0)
+                complete = false; // enabled but never scheduled on a counter
+        }
+        if (complete) {
+            counts.available |= 1u << e;
+            counts.values[e] = static_cast<uint64_t>(sum + 0.5);
+        }
+    }
+    if (counts.available != (1u << PERF_EVENT_COUNT) - 1)
+        counts.reason = reason.empty() ? "events not counted on every thread" : reason;
+    return counts;
+}
+
+#else
+
+PerfCounters::PerfCounters(bool enabled, int threads) : enabled(enabled), threads(threads < 1 ? 1 : threads)
+{
+    if (enabled)
+        reason = "hardware counters need linux perf_event_open";
+}
+
+PerfCounters::~PerfCounters() {}
+
+PerfCounts PerfCounters::stop()
+{
+    PerfCounts counts;
+    counts.collected = enabled;
+    counts.threads = threads;
+    counts.reason = reason;
+    return counts;
+}
+
+#endif
+
+string perf_report(const PerfCounts& counts)
+{
+    if (!counts.collected)
+        return "";
+
+    stringstream report;
+    report << "Hardware counters (" << counts.threads << (counts.threads == 1 ? " thread" : " threads") << "):\n";
+    if (counts.available == 0) {
+        report << "  unavailable: " << counts.reason << "\n";
+        return report.str();
+    }
+
+    static const char* labels[PERF_EVENT_COUNT] = { "Cycles", "Instructions", "LLC misses", "dTLB misses",
+                                                    "Branch mispredicts" };
+    double instructions = static_cast<double>(counts.values[PERF_INSTRUCTIONS]);
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        PerfEvent event = static_cast<PerfEvent>(e);
+        report << "  " << labels[e] << ": ";
+        if (!counts.has(event)) {
+            report << "n/a\n";
+            continue;
+        }
+        report << counts.values[e];
+        if (event == PERF_INSTRUCTIONS && counts.has(PERF_CYCLES) && counts.values[PERF_CYCLES] > 0)
+            report << " (IPC " << fixed << setprecision(2) << instructions / counts.values[PERF_CYCLES] << ")";
+        else if (event != PERF_CYCLES && event != PERF_INSTRUCTIONS && counts.has(PERF_INSTRUCTIONS) && instructions > 0)
+            report << " (" << fixed << setprecision(2) << counts.values[e] * 1000.0 / instructions << " per 1k instructions)";
+        report << "\n";
+    }
+    if (!counts.reason.empty())
+        report << "  (partial: " << counts.reason << ")\n";
+    return report.str();
+}
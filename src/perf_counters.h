@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// hardware events counted around an algorithm's kernel through perf_event_open (linux only)
+enum PerfEvent
+{
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_LLC_MISSES,     // last level cache read misses
+    PERF_DTLB_MISSES,    // data TLB read misses
+    PERF_BRANCH_MISSES,  // mispredicted branches
+    PERF_EVENT_COUNT
+};
+
+// "cycles", "instructions", "llc_misses", "dtlb_misses", "branch_misses"
+const char* perf_event_name(PerfEvent event);
+
+// counts of one run, summed over the calling thread and its OpenMP team. events the kernel or the
+// hardware does not provide (VMs, containers, perf_event_paranoid) are missing from the mask and
+// reason says why; counts are scaled up when the kernel had to multiplex counters
+struct PerfCounts
+{
+    bool collected = false; // counters were requested for the run
+    int threads = 0;
+    unsigned available = 0; // bit per PerfEvent
+    uint64_t values[PERF_EVENT_COUNT] = {};
+    std::string reason;
+
+    bool has(PerfEvent event) const { return available & (1u << event); }
+};
+
+// opens the counters on construction and reads them in stop(); does nothing when disabled. every
+// thread of a team of the given size opens its own counters in a parallel region, and the
+// algorithm's parallel regions then run on those same pool threads, so construct it after the
+// ThreadTeam and outside any parallel region
+class PerfCounters
+{
+public:
+    PerfCounters(bool enabled, int threads);
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    PerfCounts stop();
+
+private:
+    bool enabled;
+    int threads;
+    std::vector<int> fds; // threads x PERF_EVENT_COUNT, -1 where an event could not be opened
+    std::string reason;
+};
+
+// "Hardware counters" lines for an algorithm report; empty when counters were not requested
+std::string perf_report(const PerfCounts& counts);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"). a counter-based
+// generator: each output is a pure function of (key, counter), so any thread can draw the i-th
+// number of a stream directly and results do not depend on how work is split between threads
+struct Philox4x32
+{
+    uint64_t key;
+
+    explicit Philox4x32(uint64_t key) : key(key) {}
+
+    // four 32-bit words for the 128-bit counter (counter, stream)
+    void block(uint64_t counter, uint64_t stream, uint32_t out[4]) const
+    {
+        uint32_t c0 = static_cast<uint32_t>(counter), c1 = static_cast<uint32_t>(counter >> 32);
+        uint32_t c2 = static_cast<uint32_t>(stream), c3 = static_cast<uint32_t>(stream >> 32);
+        uint32_t k0 = static_cast<uint32_t>(key), k1 = static_cast<uint32_t>(key >> 32);
+
+        for (int round = 0; round < 10; round++) {
+            uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+            uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+            uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+            uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+    }
+
+    uint64_t bits64(uint64_t counter, uint64_t stream = 0) const
+    {
+        uint32_t out[4];
+        block(counter, stream, out);
+        return (static_cast<uint64_t>(out[1]) << 32) | out[0];
+    }
+
+    // uniform in [0, bound) by multiply-shift; the bias is below bound / 2^64
+    uint64_t below(uint64_t bound, uint64_t counter, uint64_t stream = 0) const
+    {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(bits64(counter, stream)) * bound) >> 64);
+    }
+
+    // uniform in [0, 1) with 53 random bits
+    double uniform(uint64_t counter, uint64_t stream = 0) const
+    {
+        return (bits64(counter, stream) >> 11) * 0x1.0p-53;
+    }
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "perf_counters.h"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+// progress reporting and cooperative cancellation for long-running algorithms.
+// algorithms take an optional pointer; nullptr means nobody is watching
+struct ProgressControl
+{
+    std::atomic<uint64_t> done{0};
+    std::atomic<uint64_t> total{0};
+    std::atomic<bool> cancel_requested{false};
+    // time of the algorithm's kernel alone, without copying inputs or writing the report;
+    // set once the algorithm finishes
+    std::atomic<double> kernel_ms{0.0};
+    // hardware counters around the kernel; set collect_counters before the call, counters is
+    // filled in once the algorithm finishes
+    bool collect_counters = false;
+    PerfCounts counters;
+
+    void start(uint64_t work_units)
+    {
+        done.store(0, std::memory_order_relaxed);
+        total.store(work_units, std::memory_order_relaxed);
+    }
+
+    void advance(uint64_t work_units) { done.fetch_add(work_units, std::memory_order_relaxed); }
+    void cancel() { cancel_requested.store(true, std::memory_order_relaxed); }
+    bool cancelled() const { return cancel_requested.load(std::memory_order_relaxed); }
+
+    double fraction() const
+    {
+        uint64_t t = total.load(std::memory_order_relaxed);
+        if (t == 0) return 0.0;
+        double f = static_cast<double>(done.load(std::memory_order_relaxed)) / t;
+        return f > 1.0 ? 1.0 : f;
+    }
+};
+
+// thrown by an algorithm, outside any parallel region, once it notices a cancel request
+struct OperationCancelled : std::runtime_error
+{
+    OperationCancelled() : std::runtime_error("Operation cancelled") {}
+};
+
+inline void progress_start(ProgressControl* progress, uint64_t work_units)
+{
+    if (progress) progress->start(work_units);
+}
+
+inline void progress_advance(ProgressControl* progress, uint64_t work_units)
+{
+    if (progress) progress->advance(work_units);
+}
+
+inline void progress_kernel_time(ProgressControl* progress, double kernel_ms)
+{
+    if (progress) progress->kernel_ms.store(kernel_ms, std::memory_order_relaxed);
+}
+
+inline bool progress_wants_counters(const ProgressControl* progress)
+{
+    return progress && progress->collect_counters;
+}
+
+inline void progress_counters(ProgressControl* progress, const PerfCounts& counts)
+{
+    if (progress) progress->counters = counts;
+}
+
+inline bool progress_cancelled(const ProgressControl* progress)
+{
+    return progress && progress->cancelled();
+}
+
+inline void throw_if_cancelled(const ProgressControl* progress)
+{
+    if (progress_cancelled(progress)) throw OperationCancelled();
+}
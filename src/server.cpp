@@ -0,0 +1,1087 @@
+#include "httplib.h"
+#include "json.hpp"
+#include "graph.h"
+#include "parallel_graph.h"
+#include "shortest_paths.h"
+#include "graph_store.h"
+#include "graph_codec.h"
+#include "graph_ingest.h"
+#include "graph_file.h"
+#include "graph_loaders.h"
+#include "graph_generators.h"
+#include "benchmark.h"
+#include "jobs.h"
+#include "metrics.h"
+#include "thread_budget.h"
+#include "trace.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+using json = nlohmann::json;
+using namespace std;
+
+// cap on /compare and /scaling warmup and trial counts, each of which reruns every variant
+static const int MAX_COMPARE_RUNS = 50;
+
+// matrix -> json rows, INF encoded as null
+static json matrix_to_json(const Matrix& matrix)
+{
+    json matrix_json = json::array();
+    for (size_t i = 0; i < matrix.size(); i++) {
+        const int* row = matrix[i];
+        json row_json = json::array();
+        for (size_t j = 0; j < matrix.size(); j++) {
+            if (row[j] == INF) {
+                row_json.push_back(json(nullptr));
+            } else {
+                row_json.push_back(row[j]);
+            }
+        }
+        matrix_json.push_back(row_json);
+    }
+    return matrix_json;
+}
+
+// components -> json array of vertex arrays
+static json components_to_json(const ComponentList& components)
+{
+    json components_json = json::array();
+    for (size_t c = 0; c < components.size(); c++) {
+        auto comp = components[c];
+        components_json.push_back(json(vector<int>(comp.begin(), comp.end())));
+    }
+    return components_json;
+}
+
+// CSR -> json array of [{"to", "weight"}, ...] per vertex
+static json csr_to_json(const GraphCSR& graph)
+{
+    json list_json = json::array();
+    for (size_t v = 0; v < graph.num_vert; v++) {
+        json adj_json = json::array();
+        for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; e++) {
+            adj_json.push_back({{"to", graph.neighbors[e]}, {"weight", graph.weights[e]}});
+        }
+        list_json.push_back(adj_json);
+    }
+    return list_json;
+}
+
+// wire formats for request bodies and responses, chosen by Content-Type / Accept
+enum class WireFormat { Json, Cbor, MsgPack, MatrixBlob, CsrBlob };
+
+static const char* wire_mime(WireFormat format)
+{
+    switch (format)
+    {
+    case WireFormat::Cbor: return "application/cbor";
+    case WireFormat::MsgPack: return "application/msgpack";
+    case WireFormat::MatrixBlob: return "application/x-graph-matrix";
+    case WireFormat::CsrBlob: return "application/x-graph-csr";
+    default: return "application/json";
+    }
+}
+
+// first known media type in a Content-Type or Accept header; JSON if there is none
+static WireFormat wire_format(const string& header)
+{
+    size_t start = 0;
+    while (start < header.size()) {
+        size_t end = min(header.find(',', start), header.size());
+        string type = header.substr(start, min(header.find(';', start), end) - start);
+        type.erase(0, type.find_first_not_of(" \t"));
+        type.erase(type.find_last_not_of(" \t") + 1);
+        transform(type.begin(), type.end(), type.begin(), ::tolower);
+
+        if (type == "application/json") return WireFormat::Json;
+        if (type == "application/cbor") return WireFormat::Cbor;
+        if (type == "application/msgpack" || type == "application/x-msgpack") return WireFormat::MsgPack;
+        if (type == "application/x-graph-matrix") return WireFormat::MatrixBlob;
+        if (type == "application/x-graph-csr") return WireFormat::CsrBlob;
+        start = end + 1;
+    }
+    return WireFormat::Json;
+}
+
+static WireFormat accepted_format(const httplib::Request& req)
+{
+    return wire_format(req.get_header_value("Accept"));
+}
+
+// request body in any wire format. an inline graph is streamed into graph rather than the
+// returned options; a raw blob body is the graph itself and the options come from the query string
+static json parse_request(const httplib::Request& req, StoredGraph& graph)
+{
+    TraceSpan span("http.parse", "http");
+    WireFormat format = wire_format(req.get_header_value("Content-Type"));
+    switch (format)
+    {
+    case WireFormat::Cbor:
+        return parse_graph_request(req.body, json::input_format_t::cbor, graph);
+    case WireFormat::MsgPack:
+        return parse_graph_request(req.body, json::input_format_t::msgpack, graph);
+    case WireFormat::MatrixBlob:
+    case WireFormat::CsrBlob: {
+        const uint8_t* blob = reinterpret_cast<const uint8_t*>(req.body.data());
+        if (format == WireFormat::MatrixBlob) {
+            graph.matrix = make_shared<const GraphMatrix>(decode_matrix_blob(blob, req.body.size()));
+        } else {
+            graph.csr = make_shared<const GraphCSR>(decode_csr_blob(blob, req.body.size()));
+        }
+
+        json j = json::object();
+        for (const auto& param : req.params) {
+            json value = json::parse(param.second, nullptr, false);
+            j[param.first] = value.is_discarded() ? json(param.second) : value;
+        }
+        return j;
+    }
+    default:
+        return parse_graph_request(req.body, json::input_format_t::json, graph);
+    }
+}
+
+// for endpoints that take no graph
+static json parse_request(const httplib::Request& req)
+{
+    StoredGraph ignored;
+    return parse_request(req, ignored);
+}
+
+// replies in the accepted format; compact JSON unless CBOR or MessagePack was asked for
+static void send_json(const httplib::Request& req, httplib::Response& res, const json& body)
+{
+    TraceSpan span("http.serialize", "http");
+    WireFormat format = accepted_format(req);
+    if (format == WireFormat::Cbor || format == WireFormat::MsgPack) {
+        vector<uint8_t> bytes = format == WireFormat::Cbor ? json::to_cbor(body) : json::to_msgpack(body);
+        res.set_content(reinterpret_cast<const char*>(bytes.data()), bytes.size(), wire_mime(format));
+    } else {
+        res.set_content(body.dump(), "application/json");
+    }
+}
+
+// resolves the graph a request refers to: a stored "graph_id", or else the inline graph
+// parse_request left in graph. on failure fills in the error response and returns false
+static bool graph_from_request(const json& j, StoredGraph& graph, httplib::Response& res, const string& missing_message)
+{
+    if (j.contains("graph_id")) {
+        string id = j.at("graph_id").get<string>();
+        if (!graph_store().get(id, graph)) {
+            res.status = 404;
+            res.set_content("Error: Unknown or evicted graph_id '" + id + "'", "text/plain");
+            return false;
+        }
+    } else if (!graph.matrix && !graph.csr) {
+        res.status = 400;
+        res.set_content(missing_message, "text/plain");
+        return false;
+    }
+    return true;
+}
+
+// with "store": true the graph is kept server-side and its id returned;
+// "include_graph": false then skips sending the graph data back
+static bool store_if_requested(const json& j, const StoredGraph& graph, json& response_json)
+{
+    if (!j.value("store", false))
+        return true;
+
+    response_json["graph_id"] = graph_store().put(graph);
+    response_json["num_vert"] = graph.num_vert();
+    return j.value("include_graph", true);
+}
+
+// replies with a created graph. JSON carries it as "matrix" or "adjList" arrays, CBOR and
+// MessagePack as a binary "matrix" or "csr" blob; a raw blob Accept gets just the blob, with
+// the graph_id of a stored graph in the X-Graph-Id header
+static void send_graph(const httplib::Request& req, httplib::Response& res, const json& j,
+                       const StoredGraph& graph, bool as_list, json response_json = json::object())
+{
+    bool include_graph = store_if_requested(j, graph, response_json);
+
+    WireFormat format = accepted_format(req);
+    if (format == WireFormat::MatrixBlob || format == WireFormat::CsrBlob) {
+        if (response_json.contains("graph_id")) {
+            res.set_header("X-Graph-Id", response_json["graph_id"].get<string>());
+        }
+        vector<uint8_t> blob = format == WireFormat::MatrixBlob ? encode_matrix_blob(*stored_matrix(graph))
+                                                                : encode_csr_blob(*stored_csr(graph));
+        res.set_content(reinterpret_cast<const char*>(blob.data()), blob.size(), wire_mime(format));
+        return;
+    }
+
+    if (include_graph) {
+        bool binary = format != WireFormat::Json;
+        if (!as_list) {
+            auto matrix = stored_matrix(graph);
+            response_json["matrix"] = binary ? json::binary(encode_matrix_blob(*matrix))
+                                             : matrix_to_json(matrix->weight_matrix);
+        } else if (binary) {
+            response_json["csr"] = json::binary(encode_csr_blob(*stored_csr(graph)));
+        } else {
+            response_json["adjList"] = csr_to_json(*stored_csr(graph));
+        }
+    }
+    send_json(req, res, response_json);
+}
+
+// number of threads requested by an algorithm call
+static int threads_from_request(const json& j)
+{
+    return j.value("num_threads", 4);
+}
+
+// "perf_counters": true asks the algorithm for hardware counters around its kernel
+static void request_counters(const json& j, ProgressControl& progress)
+{
+    progress.collect_counters = j.value("perf_counters", false);
+}
+
+// the counters of the run under "counters", when they were requested
+static void add_counters(json& response_json, const ProgressControl* progress)
+{
+    if (!progress || !progress->counters.collected)
+        return;
+
+    const PerfCounts& counts = progress->counters;
+    json counters_json;
+    counters_json["available"] = counts.available != 0;
+    counters_json["threads"] = counts.threads;
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        PerfEvent event = static_cast<PerfEvent>(e);
+        counters_json[perf_event_name(event)] = counts.has(event) ? json(counts.values[e]) : json(nullptr);
+    }
+    if (counts.has(PERF_CYCLES) && counts.has(PERF_INSTRUCTIONS) && counts.values[PERF_CYCLES] > 0)
+        counters_json["ipc"] = static_cast<double>(counts.values[PERF_INSTRUCTIONS]) / counts.values[PERF_CYCLES];
+    if (!counts.reason.empty())
+        counters_json["reason"] = counts.reason;
+    response_json["counters"] = counters_json;
+}
+
+// "report": "text" (default) is the human-readable report under "result", "json" the run's
+// statistics under "stats", "none" neither. the report is only formatted when asked for
+enum class ReportFormat { Text, Json, None };
+
+static ReportFormat report_format(const json& j)
+{
+    string format = j.value("report", string("text"));
+    if (format == "text") return ReportFormat::Text;
+    if (format == "json") return ReportFormat::Json;
+    if (format == "none") return ReportFormat::None;
+    throw invalid_argument("Unknown report format '" + format + "'");
+}
+
+static json stats_to_json(const RunStats& stats)
+{
+    json stats_json;
+    stats_json["algorithm"] = stats.algorithm;
+    stats_json["num_vert"] = stats.num_vert;
+    stats_json["threads"] = stats.threads;
+    stats_json["kernel_ms"] = stats.kernel_ms;
+    stats_json["total_ms"] = stats.total_ms;
+    if (stats.algorithm.compare(0, 2, "cc") == 0 || stats.algorithm == "johnson")
+        stats_json["num_edges"] = stats.num_edges;
+    if (stats.algorithm == "dijkstra" || stats.algorithm == "delta_stepping") {
+        stats_json["num_edges"] = stats.num_edges;
+        stats_json["num_sources"] = stats.num_sources;
+    }
+    if (stats.delta > 0)
+        stats_json["delta"] = stats.delta;
+    if (stats.tile_size > 0)
+        stats_json["tile_size"] = stats.tile_size;
+    if (stats.algorithm == "cc_afforest") {
+        stats_json["neighbor_rounds"] = stats.neighbor_rounds;
+        stats_json["giant_fraction"] = stats.giant_fraction;
+        stats_json["skipped_vertices"] = stats.skipped_vertices;
+    }
+    return stats_json;
+}
+
+// text is a callable that formats the report
+template <typename Text>
+static void add_report(json& response_json, ReportFormat format, const RunStats& stats, Text text)
+{
+    if (format == ReportFormat::Text)
+        response_json["result"] = text();
+    else if (format == ReportFormat::Json)
+        response_json["stats"] = stats_to_json(stats);
+}
+
+// each algorithm endpoint is a runner over a resolved graph, shared by the synchronous
+// handlers and /jobs. unknown options throw invalid_argument; progress may be nullptr
+typedef json (*AlgorithmRunner)(const json& j, const StoredGraph& stored, ProgressControl* progress);
+
+static json run_floyd(const json& j, const StoredGraph& stored, ProgressControl* progress)
+{
+    auto matrix = stored_matrix(stored, 1);
+    ReportFormat format = report_format(j);
+    FloydResult result = floyd_algorithm(*matrix, progress);
+
+    json response_json = json::object();
+    add_report(response_json, format, result.stats, [&] { return floyd_report(*matrix, result); });
+    add_counters(response_json, progress);
+    return response_json;
+}
+
+static json run_floyd_parallel(const json& j, const StoredGraph& stored, ProgressControl* progress)
+{
+    int num_threads = threads_from_request(j);
+    auto matrix = stored_matrix(stored, num_threads);
+
+    // "standard" row-parallel sweep or cache-"blocked" tiles
+    string mode = j.value("mode", string("standard"));
+    size_t tile_size = j.value("tile_size", DEFAULT_FLOYD_TILE_SIZE);
+    ReportFormat format = report_format(j);
+
+    FloydResult result;
+    if (mode == "blocked") {
+        result = floyd_algorithm_blocked(*matrix, num_threads, tile_size, progress);
+    } else if (mode == "standard") {
+        result = floyd_algorithm_parallel(*matrix, num_threads, progress);
+    } else {
+        throw invalid_argument("Unknown Floyd mode '" + mode + "'");
+    }
+
+    json response_json = json::object();
+    add_report(response_json, format, result.stats, [&] { return floyd_report(*matrix, result); });
+    add_counters(response_json, progress);
+    return response_json;
+}
+
+static json run_connected_components(const json& j, const StoredGraph& stored, ProgressControl* progress)
+{
+    auto csr = stored_csr(stored, 1);
+    ReportFormat format = report_format(j);
+    ComponentsResult result = connected_components_algorithm(*csr, progress);
+
+    json response_json;
+    response_json["components"] = components_to_json(result.components);
+    add_report(response_json, format, result.stats, [&] { return components_report(result); });
+    add_counters(response_json, progress);
+    return response_json;
+}
+
+static json run_connected_components_parallel(const json& j, const StoredGraph& stored, ProgressControl* progress)
+{
+    int num_threads = threads_from_request(j);
+    auto csr = stored_csr(stored, num_threads);
+
+    // "union_find" (CAS union over every edge) or "afforest" (sampling + giant component skip)
+    string algorithm = j.value("algorithm", string("union_find"));
+    ReportFormat format = report_format(j);
+
+    ComponentsResult result;
+    if (algorithm == "afforest") {
+        int neighbor_rounds = j.value("neighbor_rounds", 2);
+        result = connected_components_afforest(*csr, num_threads, neighbor_rounds, progress);
+    } else if (algorithm == "union_find") {
+        result = connected_components_algorithm_parallel(*csr, num_threads, progress);
+    } else {
+        throw invalid_argument("Unknown connected components algorithm '" + algorithm + "'");
+    }
+
+    json response_json;
+    response_json["components"] = components_to_json(result.components);
+    add_report(response_json, format, result.stats, [&] { return components_report(result); });
+    add_counters(response_json, progress);
+    return response_json;
+}
+
+// all pairs shortest paths by "method": "johnson", "floyd" (blocked) or "auto" (default), which
+// picks by density; the reply names the method that ran
+static json run_apsp(const json& j, const StoredGraph& stored, ProgressControl* progress)
+{
+    int num_threads = threads_from_request(j);
+    size_t tile_size = j.value("tile_size", DEFAULT_FLOYD_TILE_SIZE);
+    string method_name = j.value("method", string("auto"));
+    ReportFormat format = report_format(j);
+
+    auto csr = stored_csr(stored, num_threads);
+    ApspMethod method;
+    if (method_name == "auto") {
+        method = choose_apsp_method(csr->num_vert, csr->num_edges());
+    } else if (method_name == "johnson") {
+        method = ApspMethod::Johnson;
+    } else if (method_name == "floyd") {
+        method = ApspMethod::Floyd;
+    } else {
+        throw invalid_argument("Unknown APSP method '" + method_name + "'");
+    }
+
+    json response_json = json::object();
+    response_json["method"] = apsp_method_name(method);
+    if (method == ApspMethod::Johnson) {
+        FloydResult result = johnson_algorithm(*csr, num_threads, progress);
+        add_report(response_json, format, result.stats, [&] { return johnson_report(result); });
+    } else {
+        auto matrix = stored_matrix(stored, num_threads);
+        FloydResult result = floyd_algorithm_blocked(*matrix, num_threads, tile_size, progress);
+        add_report(response_json, format, result.stats, [&] { return floyd_report(*matrix, result); });
+    }
+    add_counters(response_json, progress);
+    return response_json;
+}
+
+// shortest paths from "source" (default 0) or a batch of "sources", by "method": "delta_stepping"
+// (default, parallel) or "dijkstra" (sequential). "delta" is the bucket width, 0 picks one. one
+// distance row per source, null where unreachable
+static json run_sssp(const json& j, const StoredGraph& stored, ProgressControl* progress)
+{
+    int num_threads = threads_from_request(j);
+    string method = j.value("method", string("delta_stepping"));
+    int64_t delta = j.value("delta", int64_t(0));
+    if (delta < 0)
+        throw invalid_argument("delta must be positive, or 0 to pick one");
+    vector<size_t> sources;
+    if (j.contains("sources"))
+        sources = j["sources"].get<vector<size_t>>();
+    else
+        sources.push_back(j.value("source", size_t(0)));
+    ReportFormat format = report_format(j);
+
+    auto csr = stored_csr(stored, num_threads);
+    SsspResult result;
+    if (method == "delta_stepping") {
+        result = delta_stepping_sssp(*csr, sources, num_threads, static_cast<uint64_t>(delta), progress);
+    } else if (method == "dijkstra") {
+        result = dijkstra_sssp(*csr, sources, progress);
+    } else {
+        throw invalid_argument("Unknown SSSP method '" + method + "'");
+    }
+
+    json distances = json::array();
+    for (size_t i = 0; i < result.sources.size(); i++) {
+        const int* row = result.row(i);
+        json row_json = json::array();
+        for (size_t v = 0; v < csr->num_vert; v++) {
+            if (row[v] == INF) {
+                row_json.push_back(json(nullptr));
+            } else {
+                row_json.push_back(row[v]);
+            }
+        }
+        distances.push_back(row_json);
+    }
+
+    json response_json;
+    response_json["method"] = method;
+    response_json["sources"] = result.sources;
+    response_json["distances"] = distances;
+    add_report(response_json, format, result.stats, [&] { return sssp_report(result); });
+    add_counters(response_json, progress);
+    return response_json;
+}
+
+struct AlgorithmEndpoint
+{
+    AlgorithmRunner run;
+    const char* missing_message;
+};
+
+// runners that can also be submitted as jobs, keyed by endpoint name
+static const unordered_map<string, AlgorithmEndpoint>& algorithm_runners()
+{
+    static const unordered_map<string, AlgorithmEndpoint> runners = {
+        {"floyd", {run_floyd, "Error: Graph data required for Floyd algorithm"}},
+        {"floyd_parallel", {run_floyd_parallel, "Error: Graph data required for Floyd algorithm"}},
+        {"connected_components", {run_connected_components,
+                                  "Error: Graph data required for Connected Components algorithm"}},
+        {"connected_components_parallel", {run_connected_components_parallel,
+                                           "Error: Graph data required for Connected Components algorithm"}},
+        {"apsp", {run_apsp, "Error: Graph data required for all pairs shortest paths"}},
+        {"sssp", {run_sssp, "Error: Graph data required for single source shortest paths"}},
+    };
+    return runners;
+}
+
+// metrics series of the variant a request runs, named like graph_bench's algorithms. series
+// lookups take the registry lock, so each thread keeps the ones it has used
+static AlgorithmMetrics& variant_metrics(const string& endpoint, const json& j, const StoredGraph& stored)
+{
+    string variant = endpoint;
+    if (endpoint == "connected_components")
+        variant = "cc";
+    else if (endpoint == "connected_components_parallel")
+        variant = j.value("algorithm", string("union_find")) == "afforest" ? "cc_afforest" : "cc_parallel";
+    else if (endpoint == "floyd_parallel" && j.value("mode", string("standard")) == "blocked")
+        variant = "floyd_blocked";
+    else if (endpoint == "sssp")
+        variant = j.value("method", string("delta_stepping")) == "dijkstra" ? "dijkstra" : "delta_stepping";
+    else if (endpoint == "apsp") {
+        // "auto" is resolved the way run_apsp will; the derived CSR is cached for it
+        string method = j.value("method", string("auto"));
+        auto csr = method == "auto" ? stored_csr(stored, threads_from_request(j)) : nullptr;
+        if (csr)
+            method = apsp_method_name(choose_apsp_method(csr->num_vert, csr->num_edges()));
+        variant = method == "johnson" ? "johnson" : "floyd_blocked";
+    }
+
+    thread_local unordered_map<string, AlgorithmMetrics*> cache;
+    AlgorithmMetrics*& series = cache[variant];
+    if (!series)
+        series = &metrics().algorithm(variant);
+    return *series;
+}
+
+// runs an algorithm endpoint's runner, counting the run and timing it
+static json run_measured(const string& endpoint, const json& j, const StoredGraph& stored, ProgressControl* progress)
+{
+    AlgorithmMetrics& series = variant_metrics(endpoint, j, stored);
+    series.runs.add();
+    auto start_time = chrono::steady_clock::now();
+    try {
+        json response_json = algorithm_runners().at(endpoint).run(j, stored, progress);
+        series.latency.record(chrono::duration<double>(chrono::steady_clock::now() - start_time).count());
+        return response_json;
+    } catch (...) {
+        series.errors.add();
+        throw;
+    }
+}
+
+// synchronous endpoint: resolve the graph, run, reply
+static httplib::Server::Handler algorithm_handler(const string& endpoint)
+{
+    return [endpoint](const httplib::Request& req, httplib::Response& res) {
+        try {
+            StoredGraph stored;
+            auto j = parse_request(req, stored);
+            if (!graph_from_request(j, stored, res, algorithm_runners().at(endpoint).missing_message))
+                return;
+
+            ProgressControl progress;
+            request_counters(j, progress);
+            TraceSpan run_span("http.run", "http");
+            json response_json = run_measured(endpoint, j, stored, &progress);
+            run_span.end();
+            send_json(req, res, response_json);
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(std::string("Error: ") + e.what(), "text/plain");
+        }
+    };
+}
+
+// graph files live in GRAPH_DATA_DIR (default ./data); requests name a file, never a path
+static string data_file_path(const string& name)
+{
+    if (name.empty() || name[0] == '.' || name.find_first_of("/\\") != string::npos)
+        throw invalid_argument("Invalid graph file name '" + name + "'");
+
+    const char* env = getenv("GRAPH_DATA_DIR");
+    filesystem::path dir = env ? env : "./data";
+    filesystem::create_directories(dir);
+    return (dir / name).string();
+}
+
+// a request is handled start to finish on one server thread: the pre-routing handler stamps the
+// start and the logger, which runs once the reply is written, records it
+thread_local chrono::steady_clock::time_point request_start;
+
+// route pattern with its captures collapsed, so ids don't become separate series
+static string endpoint_label(const httplib::Request& req, const httplib::Response& res)
+{
+    // replies written before routing (malformed requests) never reach the pre-routing handler
+    if (request_start == chrono::steady_clock::time_point())
+        return "invalid";
+    if (req.matched_route.empty())
+        return res.status == 404 ? "unmatched" : "static";
+
+    string label;
+    int depth = 0;
+    for (char c : req.matched_route) {
+        if (c == '(' && depth++ == 0)
+            label += ":id";
+        else if (c == ')' && depth > 0)
+            depth--;
+        else if (depth == 0)
+            label += c;
+    }
+    return label;
+}
+
+// the methods httplib accepts; anything else is a client-chosen string and would grow the series unbounded
+static const string& method_label(const string& method)
+{
+    static const unordered_set<string> known = {
+        "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH", "PRI"
+    };
+    static const string other = "other";
+    return known.count(method) ? method : other;
+}
+
+static void record_request(const httplib::Request& req, const httplib::Response& res)
+{
+    thread_local unordered_map<string, RequestMetrics*> cache;
+    const string& method = method_label(req.method);
+    string endpoint = endpoint_label(req, res);
+    RequestMetrics*& series = cache[method + " " + endpoint];
+    if (!series)
+        series = &metrics().endpoint(method, endpoint);
+
+    series->requests.add();
+    if (res.status >= 400)
+        series->errors.add();
+    series->bytes_in.add(req.body.size());
+    series->bytes_out.add(res.body.size());
+    if (request_start != chrono::steady_clock::time_point()) {
+        series->latency.record(chrono::duration<double>(chrono::steady_clock::now() - request_start).count());
+        request_start = chrono::steady_clock::time_point();
+    }
+}
+
+static json job_to_json(const JobInfo& info)
+{
+    json job_json;
+    job_json["job_id"] = info.id;
+    job_json["task"] = info.kind;
+    job_json["status"] = job_state_name(info.state);
+    job_json["progress"] = info.progress;
+    job_json["queued_ms"] = info.queued_ms;
+    job_json["running_ms"] = info.running_ms;
+    if (info.state == JobState::Failed) {
+        job_json["error"] = info.error;
+    }
+    return job_json;
+}
+
+int main() 
+{
+    httplib::Server svr;
+
+    svr.set_mount_point("/", "./web");
+
+    svr.set_pre_routing_handler([](const httplib::Request& req, httplib::Response& res) {
+        request_start = chrono::steady_clock::now();
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+        res.set_header("Access-Control-Expose-Headers", "X-Graph-Id");
+        return httplib::Server::HandlerResponse::Unhandled;
+    });
+    svr.set_logger(record_request);
+
+    svr.Options(".*", [](const httplib::Request&, httplib::Response& res) {
+        return;
+    });
+
+    // API
+    svr.Post("/generate", [](const httplib::Request& req, httplib::Response& res) {
+        try {
+            auto j = parse_request(req);
+
+            size_t num_vert = j.at("num_vert").get<size_t>();
+            size_t num_edges = j.at("num_edges").get<size_t>();
+            int max_weight = j.at("max_weight").get<int>();
+            bool is_directed = j.at("is_directed").get<bool>();
+            int graph_type = j.at("graph_type").get<int>();
+
+            // the seed is echoed back so the same graph can be generated again
+            uint64_t seed = j.value("seed", uint64_t(0));
+            if (seed == 0) seed = random_seed();
+            GraphGenerator generator = graph_generator(j.value("generator", "uniform"));
+            GraphCSR csr = generate_graph_csr(generator, num_vert, max_weight, num_edges, is_directed, seed,
+                                              j.value("num_threads", 0));
+
+            StoredGraph stored;
+            if (graph_type == 0)
+                stored.matrix = make_shared<const GraphMatrix>(csr_to_matrix(csr));
+            else
+                stored.csr = make_shared<const GraphCSR>(move(csr));
+            send_graph(req, res, j, stored, graph_type != 0, json{{"seed", seed}});
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(std::string("Error: ") + e.what(), "text/plain");
+        }
+    });
+
+    svr.Post("/create_custom", [](const httplib::Request& req, httplib::Response& res) {
+        try {
+            auto j = parse_request(req);
+            
+            size_t num_vert = j.at("num_vert").get<size_t>();
+            bool is_directed = j.at("is_directed").get<bool>();
+            int graph_type = j.at("graph_type").get<int>();
+            auto edges = j.at("edges");
+
+            if (graph_type == 0) {
+                GraphMatrix g(num_vert);
+                
+                for (const auto& edge : edges) {
+                    size_t from = edge.at("from").get<size_t>();
+                    size_t to = edge.at("to").get<size_t>();
+                    int weight = edge.at("weight").get<int>();
+                    
+                    if (from >= num_vert || to >= num_vert) {
+                        res.status = 400;
+                        res.set_content("Error: Vertex index out of range", "text/plain");
+                        return;
+                    }
+                    
+                    add_edge_matrix(g, from, to, weight, 0, is_directed);
+                }
+                
+                send_graph(req, res, j, StoredGraph{ make_shared<const GraphMatrix>(move(g)), nullptr }, false);
+            } else {
+                GraphAdjList g(num_vert);
+                
+                for (const auto& edge : edges) {
+                    size_t from = edge.at("from").get<size_t>();
+                    size_t to = edge.at("to").get<size_t>();
+                    int weight = edge.at("weight").get<int>();
+                    
+                    if (from >= num_vert || to >= num_vert) {
+                        res.status = 400;
+                        res.set_content("Error: Vertex index out of range", "text/plain");
+                        return;
+                    }
+                    
+                    add_edge_adjList(g, from, to, weight, 0, is_directed);
+                }
+                
+                send_graph(req, res, j, StoredGraph{ nullptr, make_shared<const GraphCSR>(list_to_csr(g)) }, true);
+            }
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(std::string("Error: ") + e.what(), "text/plain");
+        }
+    });
+
+    // algorithm endpoints, synchronous
+    svr.Post("/floyd", algorithm_handler("floyd"));
+    svr.Post("/connected_components", algorithm_handler("connected_components"));
+    svr.Post("/connected_components_parallel", algorithm_handler("connected_components_parallel"));
+    svr.Post("/floyd_parallel", algorithm_handler("floyd_parallel"));
+    svr.Post("/apsp", algorithm_handler("apsp"));
+    svr.Post("/sssp", algorithm_handler("sssp"));
+
+    // API for comparison
+    svr.Post("/compare", [](const httplib::Request& req, httplib::Response& res) {
+        try {
+            StoredGraph stored;
+            auto j = parse_request(req, stored);
+            if (!graph_from_request(j, stored, res, "Error: Graph data required for comparison"))
+                return;
+            int num_threads = 4; // default
+            if (j.find("num_threads") != j.end()) {
+                num_threads = j.at("num_threads").get<int>();
+            }
+            auto matrix_graph = stored_matrix(stored, num_threads);
+            auto csr_graph = stored_csr(stored, num_threads);
+
+            size_t tile_size = j.value("tile_size", DEFAULT_FLOYD_TILE_SIZE);
+            int warmup = j.value("warmup", 1);
+            int trials = j.value("trials", 5);
+            if (warmup < 0 || warmup > MAX_COMPARE_RUNS || trials < 1 || trials > MAX_COMPARE_RUNS)
+                throw std::invalid_argument("warmup and trials must be within 0.." + std::to_string(MAX_COMPARE_RUNS));
+
+            std::vector<VariantTiming> timings;
+            auto result = compare_algorithms(*matrix_graph, *csr_graph, num_threads, tile_size, warmup, trials, &timings);
+            json response_json;
+            response_json["comparison"] = result.first;
+            response_json["detailed_results"] = result.second;
+            response_json["warmup"] = warmup;
+            response_json["trials"] = trials;
+            response_json["timings"] = json::array();
+            for (const VariantTiming& t : timings) {
+                response_json["timings"].push_back({ {"algorithm", t.name},
+                                                     {"threads", t.threads},
+                                                     {"median_ms", t.kernel.median_ms},
+                                                     {"median_low_ms", t.kernel.median_low_ms},
+                                                     {"median_high_ms", t.kernel.median_high_ms},
+                                                     {"min_ms", t.kernel.min_ms},
+                                                     {"stddev_ms", t.kernel.stddev_ms},
+                                                     {"speedup", t.speedup},
+                                                     {"speedup_low", t.speedup_low},
+                                                     {"speedup_high", t.speedup_high},
+                                                     {"efficiency", t.efficiency},
+                                                     {"matches_sequential", t.matches_sequential} });
+            }
+
+            send_json(req, res, response_json);
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(std::string("Error: ") + e.what(), "text/plain");
+        }
+    });
+
+    // thread sweeps: {"mode": "strong", graph...} or {"mode": "weak", "num_vert", "num_edges", ...}
+    svr.Post("/scaling", [](const httplib::Request& req, httplib::Response& res) {
+        try {
+            StoredGraph stored;
+            auto j = parse_request(req, stored);
+            string mode = j.value("mode", string("strong"));
+            int warmup = j.value("warmup", 1);
+            int trials = j.value("trials", 3);
+            if (warmup < 0 || warmup > MAX_COMPARE_RUNS || trials < 1 || trials > MAX_COMPARE_RUNS)
+                throw std::invalid_argument("warmup and trials must be within 0.." + std::to_string(MAX_COMPARE_RUNS));
+
+            vector<string> algorithms = j.value("algorithms", vector<string>());
+            if (algorithms.empty())
+                for (const BenchAlgorithm& algorithm : bench_algorithms())
+                    algorithms.push_back(algorithm.name);
+            vector<int> threads = j.value("threads", vector<int>());
+
+            json response_json;
+            if (mode == "strong") {
+                if (!graph_from_request(j, stored, res, "Error: Graph data required for strong scaling"))
+                    return;
+                response_json["curves"] = scaling_json(strong_scaling(stored, algorithms, threads, warmup, trials));
+            } else if (mode == "weak") {
+                WeakScalingGraph base;
+                base.generator = graph_generator(j.value("generator", "uniform"));
+                base.num_vert = j.at("num_vert").get<size_t>();
+                base.floyd_num_vert = j.value("floyd_num_vert", size_t(0));
+                base.num_edges = j.value("num_edges", uint64_t(0));
+                base.max_weight = j.value("max_weight", 100);
+                base.directed = j.value("is_directed", false);
+                base.seed = j.value("seed", uint64_t(0));
+                if (base.seed == 0) base.seed = random_seed();
+                response_json["seed"] = base.seed;
+                response_json["curves"] = scaling_json(weak_scaling(base, algorithms, threads, warmup, trials));
+            } else {
+                throw std::invalid_argument("mode must be strong or weak");
+            }
+            response_json["mode"] = mode;
+            response_json["warmup"] = warmup;
+            response_json["trials"] = trials;
+            response_json["compute_threads"] = thread_budget().capacity();
+            send_json(req, res, response_json);
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(std::string("Error: ") + e.what(), "text/plain");
+        }
+    });
+
+    // asynchronous jobs: {"task": "<algorithm endpoint>", ...same fields as that endpoint}
+    svr.Post("/jobs", [](const httplib::Request& req, httplib::Response& res) {
+        try {
+            StoredGraph stored;
+            auto j = parse_request(req, stored);
+
+            string task = j.value("task", string());
+            auto runner = algorithm_runners().find(task);
+            if (runner == algorithm_runners().end()) {
+                res.status = 400;
+                res.set_content("Error: Unknown job task '" + task + "'", "text/plain");
+                return;
+            }
+
+            // the graph is resolved now so bad input is reported before queueing
+            if (!graph_from_request(j, stored, res, runner->second.missing_message))
+                return;
+
+            string id = job_queue().submit(task, [task, j, stored](ProgressControl& progress) {
+                request_counters(j, progress);
+                return run_measured(task, j, stored, &progress).dump();
+            });
+
+            JobInfo info;
+            job_queue().info(id, info);
+            res.status = 202;
+            send_json(req, res, job_to_json(info));
+        } catch (const std::length_error& e) {
+            res.status = 503;
+            res.set_content(std::string("Error: ") + e.what(), "text/plain");
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(std::string("Error: ") + e.what(), "text/plain");
+        }
+    });
+
+    svr.Get("/jobs", [](const httplib::Request& req, httplib::Response& res) {
+        json jobs_json = json::array();
+        for (const auto& info : job_queue().list()) {
+            jobs_json.push_back(job_to_json(info));
+        }
+
+        json response_json;
+        response_json["jobs"] = jobs_json;
+        response_json["pending"] = job_queue().pending();
+        response_json["running"] = job_queue().running();
+        response_json["compute_threads"] = thread_budget().capacity();
+        response_json["compute_threads_in_use"] = thread_budget().in_use();
+        send_json(req, res, response_json);
+    });
+
+    svr.Get(R"(/jobs/(\w+))", [](const httplib::Request& req, httplib::Response& res) {
+        JobInfo info;
+        if (!job_queue().info(req.matches[1], info)) {
+            res.status = 404;
+            res.set_content("Error: Unknown job_id", "text/plain");
+            return;
+        }
+        send_json(req, res, job_to_json(info));
+    });
+
+    svr.Get(R"(/jobs/(\w+)/result)", [](const httplib::Request& req, httplib::Response& res) {
+        JobInfo info;
+        if (!job_queue().info(req.matches[1], info)) {
+            res.status = 404;
+            res.set_content("Error: Unknown job_id", "text/plain");
+            return;
+        }
+
+        string body;
+        if (!job_queue().result(info.id, body)) {
+            res.status = 409;
+            send_json(req, res, job_to_json(info));
+            return;
+        }
+        if (accepted_format(req) == WireFormat::Json) {
+            res.set_content(body, "application/json");
+        } else {
+            send_json(req, res, json::parse(body));
+        }
+    });
+
+    svr.Delete(R"(/jobs/(\w+))", [](const httplib::Request& req, httplib::Response& res) {
+        if (!job_queue().cancel(req.matches[1])) {
+            res.status = 404;
+            res.set_content("Error: Unknown job_id", "text/plain");
+            return;
+        }
+
+        JobInfo info;
+        job_queue().info(req.matches[1], info);
+        send_json(req, res, job_to_json(info));
+    });
+
+    // graph files: {"file": "<name>", "graph_id" or inline graph, "include_matrix": false}
+    svr.Post("/save", [](const httplib::Request& req, httplib::Response& res) {
+        try {
+            StoredGraph stored;
+            auto j = parse_request(req, stored);
+            if (!graph_from_request(j, stored, res, "Error: Graph data required for saving"))
+                return;
+
+            string name = j.at("file").get<string>();
+            GraphFileInfo info = save_graph_file(data_file_path(name), stored, j.value("include_matrix", false));
+
+            json response_json;
+            response_json["file"] = name;
+            response_json["num_vert"] = info.num_vert;
+            response_json["num_edges"] = info.num_edges;
+            response_json["has_matrix"] = info.has_matrix;
+            response_json["file_bytes"] = info.file_bytes;
+            send_json(req, res, response_json);
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(std::string("Error: ") + e.what(), "text/plain");
+        }
+    });
+
+    // maps a graph file into the store: {"file": "<name>"}
+    svr.Post("/load", [](const httplib::Request& req, httplib::Response& res) {
+        try {
+            auto j = parse_request(req);
+            string name = j.at("file").get<string>();
+
+            string path = data_file_path(name);
+            string format = j.value("format", "");
+            int num_threads = j.value("num_threads", 0);
+
+            // graph files are mapped as they are; edge lists are parsed into a heap CSR
+            auto start_time = chrono::steady_clock::now();
+            GraphFileInfo info{};
+            StoredGraph stored;
+            if (format.empty() && is_graph_file(path)) {
+                stored = load_graph_file(path, &info);
+            } else {
+                EdgeListFormat edge_format = edge_list_format(format.empty() ? name : format);
+                stored.csr = make_shared<const GraphCSR>(
+                    load_edge_list(path, edge_format, j.value("symmetrize", false), num_threads));
+                info.num_vert = stored.csr->num_vert;
+                info.num_edges = stored.csr->num_edges();
+            }
+            double load_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count();
+
+            json response_json;
+            response_json["graph_id"] = graph_store().put(stored);
+            response_json["num_vert"] = info.num_vert;
+            response_json["num_edges"] = info.num_edges;
+            response_json["has_matrix"] = info.has_matrix;
+            response_json["load_ms"] = load_ms;
+            send_json(req, res, response_json);
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(std::string("Error: ") + e.what(), "text/plain");
+        }
+    });
+
+    // Prometheus text exposition; counters and histograms are per endpoint and algorithm variant
+    svr.Get("/metrics", [](const httplib::Request&, httplib::Response& res) {
+        vector<MetricGauge> gauges = {
+            {"graph_store_memory_bytes", "Memory held by stored graphs.", double(graph_store().memory_used())},
+            {"graph_store_memory_budget_bytes", "Graph store memory budget.", double(graph_store().budget())},
+            {"graph_store_graphs", "Graphs in the store.", double(graph_store().list().size())},
+            {"graph_compute_threads_in_use", "Compute threads held by running algorithms.", double(thread_budget().in_use())},
+            {"graph_compute_threads_capacity", "Compute thread budget.", double(thread_budget().capacity())},
+            {"graph_jobs_pending", "Jobs waiting for a worker.", double(job_queue().pending())},
+            {"graph_jobs_running", "Jobs running.", double(job_queue().running())},
+        };
+        res.set_content(metrics().prometheus(gauges), "text/plain; version=0.0.4");
+    });
+
+    // recorded spans as chrome trace json, for chrome://tracing or ui.perfetto.dev
+    svr.Get("/trace", [](const httplib::Request&, httplib::Response& res) {
+        res.set_content(trace_chrome_json(), "application/json");
+    });
+
+    // {"enabled": bool, "clear": bool}; both optional
+    svr.Post("/trace", [](const httplib::Request& req, httplib::Response& res) {
+        try {
+            auto j = parse_request(req);
+            if (j.value("clear", false))
+                clear_trace();
+            if (j.contains("enabled"))
+                set_tracing(j.at("enabled").get<bool>());
+
+            json response_json;
+            response_json["enabled"] = tracing_enabled();
+            response_json["events"] = trace_event_count();
+            send_json(req, res, response_json);
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(std::string("Error: ") + e.what(), "text/plain");
+        }
+    });
+
+    // graph store management
+    svr.Get("/graphs", [](const httplib::Request& req, httplib::Response& res) {
+        json graphs_json = json::array();
+        for (const auto& info : graph_store().list()) {
+            graphs_json.push_back({{"graph_id", info.id}, {"num_vert", info.num_vert}, {"memory_bytes", info.memory_bytes}});
+        }
+
+        json response_json;
+        response_json["graphs"] = graphs_json;
+        response_json["memory_used"] = graph_store().memory_used();
+        response_json["memory_budget"] = graph_store().budget();
+        send_json(req, res, response_json);
+    });
+
+    svr.Delete(R"(/graphs/(\w+))", [](const httplib::Request& req, httplib::Response& res) {
+        if (!graph_store().erase(req.matches[1])) {
+            res.status = 404;
+            res.set_content("Error: Unknown graph_id", "text/plain");
+            return;
+        }
+        res.set_content("{}", "application/json");
+    });
+
+    std::cout << "Server started at http://localhost:8080\n";
+    std::cout << "Open http://localhost:8080 in your browser\n";
+    svr.listen("0.0.0.0", 8080);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,639 @@
+#include "shortest_paths.h"
+#include "thread_budget.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+static const int64_t UNREACHED = numeric_limits<int64_t>::max();
+
+// monotone priority queue for Dijkstra over non-negative integer keys: bucket b > 0 holds keys
+// whose highest bit differing from the last popped key is b - 1, so a pop only redistributes one
+// bucket and no comparison depends on the heap's shape. keys pushed must be >= the last popped
+template <typename Value>
+class RadixHeap
+{
+public:
+    typedef pair<uint64_t, Value> Entry;
+
+    bool empty() const { return count == 0; }
+
+    void push(uint64_t key, Value value)
+    {
+        buckets[bucket_of(key)].emplace_back(key, value);
+        count++;
+    }
+
+    Entry pop()
+    {
+        if (buckets[0].empty())
+        {
+            int b = 1;
+            while (buckets[b].empty())
+                b++;
+            last = min_element(buckets[b].begin(), buckets[b].end())->first;
+            for (const Entry& entry : buckets[b])
+                buckets[bucket_of(entry.first)].push_back(entry);
+            buckets[b].clear();
+        }
+        Entry top = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return top;
+    }
+
+    // empties the heap for the next source, keeping the bucket storage
+    void reset()
+    {
+        for (auto& bucket : buckets)
+            bucket.clear();
+        count = 0;
+        last = 0;
+    }
+
+private:
+    int bucket_of(uint64_t key) const { return key == last ? 0 : 64 - __builtin_clzll(key ^ last); }
+
+    vector<Entry> buckets[65];
+    size_t count = 0;
+    uint64_t last = 0;
+};
+
+// potentials h with w(u, v) + h[u] - h[v] >= 0 for every edge: shortest distances from a virtual
+// source joined to every vertex by a zero-weight edge. all zero when no weight is negative
+template <typename VertexId>
+static vector<int64_t> johnson_potentials(const BasicGraphCSR<VertexId>& graph, ProgressControl* progress)
+{
+    const size_t n = graph.num_vert;
+    vector<int64_t> h(n, 0);
+    if (none_of(graph.weights.begin(), graph.weights.end(), [](int w) { return w < 0; }))
+        return h;
+
+    // bellman-ford rounds until nothing relaxes; a change in round n means a negative cycle
+    for (size_t round = 0; round <= n; round++)
+    {
+        throw_if_cancelled(progress);
+        bool changed = false;
+        for (size_t u = 0; u < n; u++)
+        {
+            for (uint64_t e = graph.offsets[u]; e < graph.offsets[u + 1]; e++)
+            {
+                VertexId v = graph.neighbors[e];
+                int64_t candidate = h[u] + graph.weights[e];
+                if (candidate < h[v])
+                {
+                    h[v] = candidate;
+                    changed = true;
+                }
+            }
+        }
+        if (!changed)
+            return h;
+    }
+    throw invalid_argument("Graph has a negative cycle");
+}
+
+template <typename VertexId>
+FloydResult johnson_algorithm(const BasicGraphCSR<VertexId>& graph, int num_threads, ProgressControl* progress)
+{
+    ThreadTeam team(num_threads);
+    int actual_threads = team.size();
+
+    auto start_time = high_resolution_clock::now();
+
+    const size_t n = graph.num_vert;
+    TraceSpan alloc_span("johnson.alloc");
+    Matrix dist(n, INF);
+    alloc_span.end();
+
+    PerfCounters counters(progress_wants_counters(progress), actual_threads);
+    TraceSpan kernel_span("johnson.kernel");
+    auto algorithm_start = high_resolution_clock::now();
+
+    TraceSpan reweight_span("johnson.reweight");
+    const vector<int64_t> h = johnson_potentials(graph, progress);
+    reweight_span.end();
+
+    MatrixView d = dist.view();
+    progress_start(progress, n);
+    TraceSpan dijkstra_span("johnson.dijkstra");
+    #pragma omp parallel
+    {
+        TraceSpan worker_span("johnson.dijkstra_worker");
+        RadixHeap<VertexId> heap;
+        vector<int64_t> reweighted(n, UNREACHED);
+        vector<VertexId> reached;
+
+        #pragma omp for schedule(dynamic, 1)
+        for (size_t s = 0; s < n; s++)
+        {
+            if (progress_cancelled(progress))
+                continue;
+
+            reweighted[s] = 0;
+            reached.push_back(static_cast<VertexId>(s));
+            heap.reset();
+            heap.push(0, static_cast<VertexId>(s));
+            while (!heap.empty())
+            {
+                auto top = heap.pop();
+                VertexId u = top.second;
+                int64_t du = static_cast<int64_t>(top.first);
+                if (du > reweighted[u])
+                    continue; // stale entry
+
+                for (uint64_t e = graph.offsets[u]; e < graph.offsets[u + 1]; e++)
+                {
+                    VertexId v = graph.neighbors[e];
+                    int64_t candidate = du + graph.weights[e] + h[u] - h[v];
+                    if (candidate < reweighted[v])
+                    {
+                        if (reweighted[v] == UNREACHED)
+                            reached.push_back(v);
+                        reweighted[v] = candidate;
+                        heap.push(static_cast<uint64_t>(candidate), v);
+                    }
+                }
+            }
+
+            // undo the reweighting and reset only what this source touched
+            int* row = d[s];
+            for (VertexId v : reached)
+            {
+                int64_t real = reweighted[v] - h[s] + h[v];
+                row[v] = static_cast<int>(min<int64_t>(real, INF));
+                reweighted[v] = UNREACHED;
+            }
+            reached.clear();
+            progress_advance(progress, 1);
+        }
+    }
+    dijkstra_span.end();
+    throw_if_cancelled(progress);
+
+    auto algorithm_end = high_resolution_clock::now();
+    kernel_span.end();
+
+    RunStats stats;
+    stats.algorithm = "johnson";
+    stats.num_vert = n;
+    stats.num_edges = graph.num_edges();
+    stats.threads = actual_threads;
+    stats.counters = counters.stop();
+    stats.kernel_ms = duration_cast<microseconds>(algorithm_end - algorithm_start).count() / 1000.0;
+    stats.total_ms = duration_cast<microseconds>(high_resolution_clock::now() - start_time).count() / 1000.0;
+    progress_kernel_time(progress, stats.kernel_ms);
+    progress_counters(progress, stats.counters);
+
+    return FloydResult{ move(dist), move(stats) };
+}
+
+template FloydResult johnson_algorithm<uint32_t>(const GraphCSR&, int, ProgressControl*);
+template FloydResult johnson_algorithm<uint64_t>(const GraphCSR64&, int, ProgressControl*);
+
+ApspMethod choose_apsp_method(size_t num_vert, uint64_t num_edges)
+{
+    if (num_vert < 2)
+        return ApspMethod::Floyd;
+    double n = static_cast<double>(num_vert);
+    double johnson_work = (n + num_edges) * log2(n) * JOHNSON_RELAX_COST;
+    return johnson_work < n * n ? ApspMethod::Johnson : ApspMethod::Floyd;
+}
+
+const char* apsp_method_name(ApspMethod method)
+{
+    return method == ApspMethod::Johnson ? "johnson" : "floyd";
+}
+
+string johnson_report(const FloydResult& johnson)
+{
+    TraceSpan span("johnson.report");
+    const RunStats& stats = johnson.stats;
+    const size_t n = stats.num_vert;
+    stringstream result;
+
+    result << "Johnson's Algorithm (All Pairs Shortest Paths)\n";
+    result << "Graph size: " << n << " vertices\n";
+    result << "Number of edges: " << stats.num_edges << "\n";
+    result << "Number of threads: " << stats.threads << "\n";
+    result << "Time complexity: O(V E log V) = O(" << n << " · " << stats.num_edges << " · log " << n << ")\n\n";
+
+    if (n <= 20)
+    {
+        result << "Final shortest paths matrix:\n";
+        for (size_t i = 0; i < n; i++)
+        {
+            const int* row = johnson.dist[i];
+            for (size_t j = 0; j < n; j++)
+            {
+                if (row[j] == INF)
+                    result << "∞ ";
+                else
+                    result << row[j] << " ";
+            }
+            result << "\n";
+        }
+        result << "\n";
+    }
+
+    result << string(50, '=') << "\n";
+    result << "PERFORMANCE BENCHMARK:\n";
+    result << string(50, '=') << "\n";
+    result << "Algorithm execution time: " << format_time(stats.kernel_ms) << "\n";
+    result << "Total time (including I/O): " << format_time(stats.total_ms) << "\n";
+    if (stats.kernel_ms > 0)
+    {
+        result << "Sources per second: " << fixed << setprecision(0) << (n * 1000.0 / stats.kernel_ms) << "\n";
+    }
+    result << perf_report(stats.counters);
+
+    return result.str();
+}
+
+template <typename VertexId>
+static void check_sssp_input(const BasicGraphCSR<VertexId>& graph, const vector<size_t>& sources)
+{
+    if (sources.empty())
+        throw invalid_argument("Shortest paths need at least one source");
+    for (size_t s : sources)
+    {
+        if (s >= graph.num_vert)
+            throw invalid_argument("Source vertex " + to_string(s) + " is out of range");
+    }
+    if (any_of(graph.weights.begin(), graph.weights.end(), [](int w) { return w < 0; }))
+        throw invalid_argument("Single source shortest paths need non-negative weights");
+}
+
+template <typename VertexId>
+static RunStats sssp_stats(const char* algorithm, const BasicGraphCSR<VertexId>& graph, size_t num_sources)
+{
+    RunStats stats;
+    stats.algorithm = algorithm;
+    stats.num_vert = graph.num_vert;
+    stats.num_edges = graph.num_edges();
+    stats.num_sources = num_sources;
+    return stats;
+}
+
+template <typename VertexId>
+SsspResult dijkstra_sssp(const BasicGraphCSR<VertexId>& graph, const vector<size_t>& sources, ProgressControl* progress)
+{
+    check_sssp_input(graph, sources);
+
+    // a sequential run still occupies one core of the compute budget
+    ThreadTeam team(1);
+
+    auto start_time = high_resolution_clock::now();
+
+    const size_t n = graph.num_vert;
+    SsspResult result;
+    result.sources = sources;
+    result.stats = sssp_stats("dijkstra", graph, sources.size());
+    result.stats.threads = team.size();
+    result.dist.assign(sources.size() * n, INF);
+
+    PerfCounters counters(progress_wants_counters(progress), team.size());
+    TraceSpan kernel_span("dijkstra.kernel");
+    auto algorithm_start = high_resolution_clock::now();
+
+    RadixHeap<VertexId> heap;
+    vector<int64_t> dist(n, UNREACHED);
+    vector<VertexId> reached;
+    progress_start(progress, sources.size());
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        throw_if_cancelled(progress);
+
+        VertexId s = static_cast<VertexId>(sources[i]);
+        dist[s] = 0;
+        reached.push_back(s);
+        heap.reset();
+        heap.push(0, s);
+        while (!heap.empty())
+        {
+            auto top = heap.pop();
+            VertexId u = top.second;
+            int64_t du = static_cast<int64_t>(top.first);
+            if (du > dist[u])
+                continue; // stale entry
+
+            for (uint64_t e = graph.offsets[u]; e < graph.offsets[u + 1]; e++)
+            {
+                VertexId v = graph.neighbors[e];
+                int64_t candidate = du + graph.weights[e];
+                if (candidate < dist[v])
+                {
+                    if (dist[v] == UNREACHED)
+                        reached.push_back(v);
+                    dist[v] = candidate;
+                    heap.push(static_cast<uint64_t>(candidate), v);
+                }
+            }
+        }
+
+        int* row = result.dist.data() + i * n;
+        for (VertexId v : reached)
+        {
+            row[v] = static_cast<int>(min<int64_t>(dist[v], INF));
+            dist[v] = UNREACHED;
+        }
+        reached.clear();
+        progress_advance(progress, 1);
+    }
+
+    auto algorithm_end = high_resolution_clock::now();
+    kernel_span.end();
+
+    RunStats& stats = result.stats;
+    stats.counters = counters.stop();
+    stats.kernel_ms = duration_cast<microseconds>(algorithm_end - algorithm_start).count() / 1000.0;
+    stats.total_ms = duration_cast<microseconds>(high_resolution_clock::now() - start_time).count() / 1000.0;
+    progress_kernel_time(progress, stats.kernel_ms);
+    progress_counters(progress, stats.counters);
+    return result;
+}
+
+template SsspResult dijkstra_sssp<uint32_t>(const GraphCSR&, const vector<size_t>&, ProgressControl*);
+template SsspResult dijkstra_sssp<uint64_t>(const GraphCSR64&, const vector<size_t>&, ProgressControl*);
+
+// smallest delta that keeps delta_bin_count within MAX_DELTA_BINS
+static uint64_t min_delta(int max_weight)
+{
+    return max<uint64_t>(1, (static_cast<uint64_t>(max_weight) + MAX_DELTA_BINS - 2) / (MAX_DELTA_BINS - 1));
+}
+
+// bucket width when none is given: a vertex's lightest edges tend to land in the current bucket
+// once delta is the largest weight over the average out-degree
+template <typename VertexId>
+static uint64_t default_delta(const BasicGraphCSR<VertexId>& graph, int max_weight)
+{
+    if (graph.num_vert == 0 || graph.num_edges() == 0)
+        return 1;
+    double average_degree = static_cast<double>(graph.num_edges()) / graph.num_vert;
+    uint64_t delta = static_cast<uint64_t>(max_weight / average_degree);
+    // dense graphs would otherwise ask for more than MAX_DELTA_BINS
+    return max(delta, min_delta(max_weight));
+}
+
+// relaxing bin b only files vertices into bins b .. b + ceil(max_weight / delta), so that many
+// bins plus one, reused cyclically, hold everything pending
+static size_t delta_bin_count(int max_weight, uint64_t delta)
+{
+    return static_cast<size_t>((static_cast<uint64_t>(max_weight) + delta - 1) / delta) + 1;
+}
+
+static const size_t NO_BIN = numeric_limits<size_t>::max();
+
+// a thread relaxes its share of the current bin on its own while the share stays below this,
+// instead of paying two barriers for a handful of vertices
+static const size_t BIN_FUSION_THRESHOLD = 1000;
+
+// CAS-min every out-edge of u, filing improved vertices into this thread's bins
+template <typename VertexId>
+static void relax_edges(const BasicGraphCSR<VertexId>& graph, VertexId u, uint64_t delta, int64_t* dist,
+                        vector<vector<VertexId>>& bins)
+{
+    int64_t du = __atomic_load_n(&dist[u], __ATOMIC_RELAXED);
+    for (uint64_t e = graph.offsets[u]; e < graph.offsets[u + 1]; e++)
+    {
+        VertexId v = graph.neighbors[e];
+        int64_t candidate = du + graph.weights[e];
+        int64_t current = __atomic_load_n(&dist[v], __ATOMIC_RELAXED);
+        while (candidate < current)
+        {
+            if (__atomic_compare_exchange_n(&dist[v], &current, candidate, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                bins[static_cast<size_t>(candidate) / delta % bins.size()].push_back(v);
+                break;
+            }
+        }
+    }
+}
+
+// one source over the team; dist must be all UNREACHED. the frontier holds the bin being
+// relaxed, gathered from every thread's bins; a vertex may appear more than once. bin b lives in
+// slot b % num_bins, and every pending bin lies within num_bins of the current one
+template <typename VertexId>
+static void delta_step(const BasicGraphCSR<VertexId>& graph, VertexId source, uint64_t delta, size_t num_bins,
+                       int64_t* dist, vector<VertexId>& frontier, ProgressControl* progress)
+{
+    dist[source] = 0;
+    frontier.assign(1, source);
+
+    // the current and next bin index and frontier length swap slots every round
+    size_t shared_bin[2] = { 0, NO_BIN };
+    size_t frontier_tail[2] = { 1, 0 };
+
+    #pragma omp parallel
+    {
+        TraceSpan worker_span("delta_stepping.worker");
+        vector<vector<VertexId>> bins(num_bins);
+
+        for (size_t round = 0; shared_bin[round & 1] != NO_BIN; round++)
+        {
+            size_t& curr_bin = shared_bin[round & 1];
+            size_t& next_bin = shared_bin[(round + 1) & 1];
+            size_t& curr_tail = frontier_tail[round & 1];
+            size_t& next_tail = frontier_tail[(round + 1) & 1];
+            const size_t bin = curr_bin;
+            vector<VertexId>& current = bins[bin % num_bins];
+
+            const bool cancelled = progress_cancelled(progress);
+            const int64_t bin_floor = static_cast<int64_t>(bin * delta);
+            #pragma omp for nowait schedule(dynamic, 64)
+            for (size_t i = 0; i < curr_tail; i++)
+            {
+                VertexId u = frontier[i];
+                if (!cancelled && __atomic_load_n(&dist[u], __ATOMIC_RELAXED) >= bin_floor)
+                    relax_edges(graph, u, delta, dist, bins);
+            }
+
+            // a cancelled run drops its pending work, so the rounds drain
+            if (cancelled)
+            {
+                for (auto& pending : bins)
+                    pending.clear();
+            }
+            while (!current.empty() && current.size() < BIN_FUSION_THRESHOLD)
+            {
+                vector<VertexId> fused;
+                fused.swap(current);
+                for (VertexId u : fused)
+                    relax_edges(graph, u, delta, dist, bins);
+            }
+
+            for (size_t b = bin; b < bin + num_bins; b++)
+            {
+                if (!bins[b % num_bins].empty())
+                {
+                    #pragma omp critical(delta_step_next_bin)
+                    next_bin = min(next_bin, b);
+                    break;
+                }
+            }
+            #pragma omp barrier
+
+            // the current slots become the next round's next slots
+            #pragma omp single nowait
+            {
+                curr_bin = NO_BIN;
+                curr_tail = 0;
+            }
+
+            size_t copy_start = 0, copy_count = 0;
+            vector<VertexId>* next = next_bin == NO_BIN ? nullptr : &bins[next_bin % num_bins];
+            if (next && !next->empty())
+            {
+                copy_count = next->size();
+                copy_start = __atomic_fetch_add(&next_tail, copy_count, __ATOMIC_RELAXED);
+            }
+            #pragma omp barrier
+
+            #pragma omp single
+            {
+                if (frontier.size() < next_tail)
+                    frontier.resize(next_tail);
+            }
+
+            if (copy_count > 0)
+            {
+                copy(next->begin(), next->end(), frontier.begin() + copy_start);
+                next->clear();
+            }
+            #pragma omp barrier
+        }
+    }
+}
+
+template <typename VertexId>
+SsspResult delta_stepping_sssp(const BasicGraphCSR<VertexId>& graph, const vector<size_t>& sources, int num_threads,
+                               uint64_t delta, ProgressControl* progress)
+{
+    check_sssp_input(graph, sources);
+    int max_weight = graph.num_edges() == 0 ? 0 : *max_element(graph.weights.begin(), graph.weights.end());
+    if (delta == 0)
+        delta = default_delta(graph, max_weight);
+    if (delta < min_delta(max_weight))
+        throw invalid_argument("delta must be at least " + to_string(min_delta(max_weight)) +
+                               " for weights up to " + to_string(max_weight));
+    const size_t num_bins = delta_bin_count(max_weight, delta);
+
+    ThreadTeam team(num_threads);
+    int actual_threads = team.size();
+
+    auto start_time = high_resolution_clock::now();
+
+    const size_t n = graph.num_vert;
+    SsspResult result;
+    result.sources = sources;
+    result.stats = sssp_stats("delta_stepping", graph, sources.size());
+    result.stats.threads = actual_threads;
+    result.stats.delta = delta;
+    TraceSpan alloc_span("delta_stepping.alloc");
+    result.dist.assign(sources.size() * n, INF);
+    vector<int64_t> dist(n);
+    vector<VertexId> frontier;
+    alloc_span.end();
+
+    PerfCounters counters(progress_wants_counters(progress), actual_threads);
+    TraceSpan kernel_span("delta_stepping.kernel");
+    auto algorithm_start = high_resolution_clock::now();
+
+    progress_start(progress, sources.size());
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        throw_if_cancelled(progress);
+
+        #pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < n; v++)
+            dist[v] = UNREACHED;
+
+        delta_step(graph, static_cast<VertexId>(sources[i]), delta, num_bins, dist.data(), frontier, progress);
+        throw_if_cancelled(progress);
+
+        int* row = result.dist.data() + i * n;
+        #pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < n; v++)
+        {
+            if (dist[v] != UNREACHED)
+                row[v] = static_cast<int>(min<int64_t>(dist[v], INF));
+        }
+        progress_advance(progress, 1);
+    }
+
+    auto algorithm_end = high_resolution_clock::now();
+    kernel_span.end();
+
+    RunStats& stats = result.stats;
+    stats.counters = counters.stop();
+    stats.kernel_ms = duration_cast<microseconds>(algorithm_end - algorithm_start).count() / 1000.0;
+    stats.total_ms = duration_cast<microseconds>(high_resolution_clock::now() - start_time).count() / 1000.0;
+    progress_kernel_time(progress, stats.kernel_ms);
+    progress_counters(progress, stats.counters);
+    return result;
+}
+
+template SsspResult delta_stepping_sssp<uint32_t>(const GraphCSR&, const vector<size_t>&, int, uint64_t,
+                                                  ProgressControl*);
+template SsspResult delta_stepping_sssp<uint64_t>(const GraphCSR64&, const vector<size_t>&, int, uint64_t,
+                                                  ProgressControl*);
+
+string sssp_report(const SsspResult& sssp)
+{
+    TraceSpan span("sssp.report");
+    const RunStats& stats = sssp.stats;
+    const size_t n = stats.num_vert;
+    const bool delta_stepping = stats.algorithm == "delta_stepping";
+    stringstream result;
+
+    result << (delta_stepping ? "Delta-Stepping" : "Dijkstra's Algorithm") << " (Single Source Shortest Paths)\n";
+    result << "Graph size: " << n << " vertices\n";
+    result << "Number of edges: " << stats.num_edges << "\n";
+    result << "Number of sources: " << stats.num_sources << "\n";
+    result << "Number of threads: " << stats.threads << "\n";
+    if (delta_stepping)
+        result << "Bucket width (delta): " << stats.delta << "\n";
+    result << "\n";
+
+    if (n <= 20 && sssp.sources.size() <= 20)
+    {
+        result << "Distances by source:\n";
+        for (size_t i = 0; i < sssp.sources.size(); i++)
+        {
+            const int* row = sssp.row(i);
+            result << sssp.sources[i] << ": ";
+            for (size_t v = 0; v < n; v++)
+            {
+                if (row[v] == INF)
+                    result << "∞ ";
+                else
+                    result << row[v] << " ";
+            }
+            result << "\n";
+        }
+        result << "\n";
+    }
+
+    result << string(50, '=') << "\n";
+    result << "PERFORMANCE BENCHMARK:\n";
+    result << string(50, '=') << "\n";
+    result << "Algorithm execution time: " << format_time(stats.kernel_ms) << "\n";
+    result << "Total time (including I/O): " << format_time(stats.total_ms) << "\n";
+    if (stats.kernel_ms > 0)
+    {
+        double edges = static_cast<double>(stats.num_edges) * stats.num_sources;
+        result << "Edges traversed per second: " << fixed << setprecision(0) << (edges * 1000.0 / stats.kernel_ms) << "\n";
+    }
+    result << perf_report(stats.counters);
+
+    return result.str();
+}
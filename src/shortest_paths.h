@@ -0,0 +1,59 @@
+#pragma once
+
+#include "graph.h"
+#include <string>
+#include <vector>
+
+// all-pairs shortest paths for sparse graphs. a Bellman-Ford pass from a virtual source makes
+// every edge weight non-negative (skipped when none is negative), then each source runs its own
+// Dijkstra over the CSR. sources are spread over the team and every thread reuses one heap and
+// one distance array. O(V E log V) against Floyd's O(V³); unreachable pairs are INF.
+// progress counts finished sources; throws std::invalid_argument on a negative cycle
+template <typename VertexId>
+FloydResult johnson_algorithm(const BasicGraphCSR<VertexId>& graph, int num_threads = 0,
+                              ProgressControl* progress = nullptr);
+
+enum class ApspMethod { Floyd, Johnson };
+
+// Johnson once its heap work, about (V + E) log V relaxations per source, costs less than
+// Floyd's V² SIMD cell updates per pivot; a heap relaxation is taken to cost JOHNSON_RELAX_COST cells
+const double JOHNSON_RELAX_COST = 16.0;
+ApspMethod choose_apsp_method(size_t num_vert, uint64_t num_edges);
+
+// "floyd" or "johnson"
+const char* apsp_method_name(ApspMethod method);
+
+// text report of a Johnson run; graphs of up to 20 vertices also list the distance matrix
+std::string johnson_report(const FloydResult& result);
+
+// distances from a batch of sources: row i holds the distances from sources[i], INF where unreachable
+struct SsspResult
+{
+    std::vector<size_t> sources;
+    std::vector<int> dist; // sources.size() rows of stats.num_vert
+    RunStats stats;
+
+    const int* row(size_t i) const { return dist.data() + i * stats.num_vert; }
+};
+
+// sequential baseline: one radix-heap Dijkstra per source, in turn. progress counts finished
+// sources; throws std::invalid_argument on a negative weight or a source out of range
+template <typename VertexId>
+SsspResult dijkstra_sssp(const BasicGraphCSR<VertexId>& graph, const std::vector<size_t>& sources,
+                         ProgressControl* progress = nullptr);
+
+// each thread reuses this many distance buckets at most, cyclically; smaller deltas are rejected
+const size_t MAX_DELTA_BINS = 1 << 16;
+
+// parallel delta-stepping, one source at a time over the whole team. vertices are bucketed by
+// distance / delta and each round relaxes the lowest non-empty bucket in parallel with CAS-min
+// updates; a thread keeps relaxing its own share of the bucket while it stays small, so sparse
+// rounds don't pay for a barrier. small deltas approach Dijkstra's work, large ones Bellman-Ford's
+// parallelism; delta 0 picks the largest weight over the average degree. same errors as dijkstra_sssp,
+// and std::invalid_argument for a delta too small to fit the weights in MAX_DELTA_BINS buckets
+template <typename VertexId>
+SsspResult delta_stepping_sssp(const BasicGraphCSR<VertexId>& graph, const std::vector<size_t>& sources,
+                               int num_threads = 0, uint64_t delta = 0, ProgressControl* progress = nullptr);
+
+// text report of either; graphs of up to 20 vertices also list the distances of up to 20 sources
+std::string sssp_report(const SsspResult& result);
@@ -0,0 +1,91 @@
+#include "thread_budget.h"
+
+#include <cstdlib>
+#include <thread>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+ThreadBudget::ThreadBudget(int capacity)
+    : total(capacity > 0 ? capacity : 1), available(total), next_ticket(0), now_serving(0)
+{
+}
+
+int ThreadBudget::acquire(int wanted)
+{
+    wanted = team_size(wanted);
+
+    // tickets keep a large team from being starved by a stream of small ones
+    unique_lock<mutex> lock(budget_mutex);
+    unsigned long long ticket = next_ticket++;
+    freed.wait(lock, [&] { return ticket == now_serving && available >= wanted; });
+    available -= wanted;
+    now_serving++;
+    lock.unlock();
+
+    freed.notify_all();
+    return wanted;
+}
+
+void ThreadBudget::release(int threads)
+{
+    {
+        lock_guard<mutex> lock(budget_mutex);
+        available += threads;
+    }
+    freed.notify_all();
+}
+
+int ThreadBudget::in_use() const
+{
+    lock_guard<mutex> lock(budget_mutex);
+    return total - available;
+}
+
+// without OpenMP every region runs on the calling thread, so one thread is all a team needs
+ThreadTeam::ThreadTeam(int wanted, ThreadBudget& budget)
+    : budget(budget), previous_threads(1)
+{
+    #ifndef _OPENMP
+    wanted = 1;
+    #endif
+    threads = budget.acquire(wanted);
+
+    #ifdef _OPENMP
+    previous_threads = omp_get_max_threads();
+    omp_set_num_threads(threads);
+    #endif
+}
+
+ThreadTeam::ThreadTeam(int wanted) : ThreadTeam(wanted, thread_budget())
+{
+}
+
+ThreadTeam::~ThreadTeam()
+{
+    #ifdef _OPENMP
+    omp_set_num_threads(previous_threads);
+    #endif
+    budget.release(threads);
+}
+
+ThreadBudget& thread_budget()
+{
+    static ThreadBudget budget = [] {
+        const char* env = getenv("GRAPH_COMPUTE_THREADS");
+        int threads = env ? atoi(env) : 0;
+        if (threads <= 0)
+        {
+            #ifdef _OPENMP
+            threads = omp_get_num_procs();
+            #else
+            threads = static_cast<int>(thread::hardware_concurrency());
+            #endif
+        }
+        return ThreadBudget(threads);
+    }();
+    return budget;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+// admission control for OpenMP compute threads shared by concurrent requests. a request
+// asks for a team, waits until that many threads are free (first come, first served) and
+// gives them back when done, so the busy threads never exceed the capacity
+class ThreadBudget
+{
+public:
+    explicit ThreadBudget(int capacity);
+
+    ThreadBudget(const ThreadBudget&) = delete;
+    ThreadBudget& operator=(const ThreadBudget&) = delete;
+
+    // blocks until the team is free and returns its size; wanted <= 0 or above the
+    // capacity asks for the whole capacity
+    int acquire(int wanted);
+    void release(int threads);
+
+    // size of the team acquire(wanted) hands out
+    int team_size(int wanted) const { return wanted <= 0 || wanted > total ? total : wanted; }
+
+    int capacity() const { return total; }
+    int in_use() const;
+
+private:
+    mutable std::mutex budget_mutex;
+    std::condition_variable freed;
+    int total;
+    int available;
+    unsigned long long next_ticket;
+    unsigned long long now_serving;
+};
+
+// team held for the lifetime of one algorithm call. while it is alive, parallel regions
+// started by the calling thread use the team size; the caller's previous OpenMP thread
+// count is restored on exit so nothing leaks into later requests on the same thread
+class ThreadTeam
+{
+public:
+    explicit ThreadTeam(int wanted, ThreadBudget& budget);
+    explicit ThreadTeam(int wanted);
+    ~ThreadTeam();
+
+    ThreadTeam(const ThreadTeam&) = delete;
+    ThreadTeam& operator=(const ThreadTeam&) = delete;
+
+    int size() const { return threads; }
+
+private:
+    ThreadBudget& budget;
+    int threads;
+    int previous_threads;
+};
+
+// process-wide budget; GRAPH_COMPUTE_THREADS sets its capacity (default: all cores)
+ThreadBudget& thread_budget();
@@ -0,0 +1,162 @@
+#include "trace.h"
+#include "json.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+using json = nlohmann::json;
+
+struct TraceEvent
+{
+    const char* name;
+    const char* category;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+};
+
+// one thread's ring. the lock is only ever contended while a trace is being written out
+struct TraceBuffer
+{
+    mutex lock;
+    vector<TraceEvent> events;
+    size_t next = 0;
+    bool wrapped = false;
+    int tid = 0;
+};
+
+struct TraceRegistry
+{
+    mutex lock;
+    vector<shared_ptr<TraceBuffer>> buffers;
+    size_t capacity = 16384;
+    atomic<bool> enabled{false};
+    chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+
+    TraceRegistry()
+    {
+        if (const char* events = getenv("GRAPH_TRACE_EVENTS")) {
+            long value = atol(events);
+            if (value > 0) capacity = static_cast<size_t>(value);
+        }
+        const char* on = getenv("GRAPH_TRACE");
+        enabled.store(on && string(on) != "0", memory_order_relaxed);
+    }
+};
+
+static TraceRegistry& registry()
+{
+    static TraceRegistry instance;
+    return instance;
+}
+
+static uint64_t now_ns()
+{
+    // offset by one so a span started at the epoch is not mistaken for "not tracing"
+    auto elapsed = chrono::steady_clock::now() - registry().epoch;
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(elapsed).count()) + 1;
+}
+
+static TraceBuffer& thread_buffer()
+{
+    thread_local shared_ptr<TraceBuffer> buffer;
+    if (!buffer) {
+        TraceRegistry& reg = registry();
+        buffer = make_shared<TraceBuffer>();
+        lock_guard<mutex> guard(reg.lock);
+        buffer->events.resize(reg.capacity);
+        buffer->tid = static_cast<int>(reg.buffers.size()) + 1;
+        reg.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+TraceSpan::TraceSpan(const char* name, const char* category)
+    : name(name), category(category), start_ns(0)
+{
+    if (registry().enabled.load(memory_order_relaxed))
+        start_ns = now_ns();
+}
+
+void TraceSpan::end()
+{
+    if (start_ns == 0)
+        return;
+
+    uint64_t end_ns = now_ns();
+    TraceBuffer& buffer = thread_buffer();
+    lock_guard<mutex> guard(buffer.lock);
+    buffer.events[buffer.next] = TraceEvent{ name, category, start_ns - 1, end_ns - start_ns };
+    if (++buffer.next == buffer.events.size()) {
+        buffer.next = 0;
+        buffer.wrapped = true;
+    }
+    start_ns = 0;
+}
+
+void set_tracing(bool enabled)
+{
+    registry().enabled.store(enabled, memory_order_relaxed);
+}
+
+bool tracing_enabled()
+{
+    return registry().enabled.load(memory_order_relaxed);
+}
+
+// the registry's buffer list, so the buffers can be locked one at a time
+static vector<shared_ptr<TraceBuffer>> all_buffers()
+{
+    TraceRegistry& reg = registry();
+    lock_guard<mutex> guard(reg.lock);
+    return reg.buffers;
+}
+
+void clear_trace()
+{
+    for (const auto& buffer : all_buffers()) {
+        lock_guard<mutex> guard(buffer->lock);
+        buffer->next = 0;
+        buffer->wrapped = false;
+    }
+}
+
+size_t trace_event_count()
+{
+    size_t count = 0;
+    for (const auto& buffer : all_buffers()) {
+        lock_guard<mutex> guard(buffer->lock);
+        count += buffer->wrapped ? buffer->events.size() : buffer->next;
+    }
+    return count;
+}
+
+string trace_chrome_json()
+{
+    json events = json::array();
+    for (const auto& buffer : all_buffers()) {
+        lock_guard<mutex> guard(buffer->lock);
+        size_t count = buffer->wrapped ? buffer->events.size() : buffer->next;
+        if (count == 0)
+            continue;
+
+        events.push_back({ {"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", buffer->tid},
+                           {"args", { {"name", "thread " + to_string(buffer->tid)} }} });
+        size_t first = buffer->wrapped ? buffer->next : 0;
+        for (size_t i = 0; i < count; i++) {
+            const TraceEvent& event = buffer->events[(first + i) % buffer->events.size()];
+            events.push_back({ {"name", event.name},
+                               {"cat", event.category},
+                               {"ph", "X"},
+                               {"ts", event.start_ns / 1000.0},
+                               {"dur", event.duration_ns / 1000.0},
+                               {"pid", 1},
+                               {"tid", buffer->tid} });
+        }
+    }
+    return json{ {"traceEvents", events}, {"displayTimeUnit", "ms"} }.dump();
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// low-overhead phase tracing. a span records its name, start and duration into a ring buffer owned
+// by the recording thread, so threads never contend and the oldest spans are overwritten once the
+// buffer is full (GRAPH_TRACE_EVENTS per thread, default 16384). while tracing is off a span costs
+// one relaxed atomic load. GRAPH_TRACE=1 turns tracing on at startup
+class TraceSpan
+{
+public:
+    // name and category are kept as pointers: pass string literals
+    explicit TraceSpan(const char* name, const char* category = "algorithm");
+    ~TraceSpan() { end(); }
+
+    // records the span now rather than at scope exit, for phases that share a scope
+    void end();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    uint64_t start_ns; // 0 when tracing was off at construction
+};
+
+void set_tracing(bool enabled);
+bool tracing_enabled();
+
+// drops every recorded span; buffers stay allocated
+void clear_trace();
+
+// spans currently held across all threads
+size_t trace_event_count();
+
+// every buffered span as chrome trace event json ({"traceEvents": [...]}), oldest first per thread.
+// chrome://tracing and ui.perfetto.dev open it directly
+std::string trace_chrome_json();
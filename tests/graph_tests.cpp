@@ -1,10 +1,32 @@
 #include "graph.h"
 #include "parallel_graph.h"
-#include "googletest/googletest/include/gtest/gtest.h"
+#include "shortest_paths.h"
+#include "minplus.h"
+#include "graph_store.h"
+#include "graph_codec.h"
+#include "graph_ingest.h"
+#include "graph_file.h"
+#include "graph_loaders.h"
+#include "graph_generators.h"
+#include "benchmark.h"
+#include "jobs.h"
+#include "metrics.h"
+#include "thread_budget.h"
+#include "trace.h"
+#include <gtest/gtest.h>
 #include <vector>
 #include <limits>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
 
-const int INF = std::numeric_limits<int>::max() / 2;
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 class GraphTest : public ::testing::Test {
 protected:
@@ -65,7 +87,7 @@ TEST_F(GraphTest, GraphConversion) {
 }
 
 TEST_F(GraphTest, FloydWarshallSequential) {
-    auto [dist, report] = floyd_algorithm(small_directed_matrix);
+    auto [dist, stats] = floyd_algorithm(small_directed_matrix);
     
     // check some shortest paths
     EXPECT_EQ(dist[0][0], 0);
@@ -78,7 +100,7 @@ TEST_F(GraphTest, FloydWarshallSequential) {
 }
 
 TEST_F(GraphTest, FloydWarshallParallel) {
-    auto [dist, report] = floyd_algorithm_parallel(small_directed_matrix, 2);
+    auto [dist, stats] = floyd_algorithm_parallel(small_directed_matrix, 2);
     
     // check some shortest paths (should match sequential)
     EXPECT_EQ(dist[0][0], 0);
@@ -88,13 +110,125 @@ TEST_F(GraphTest, FloydWarshallParallel) {
     EXPECT_EQ(dist[3][0], INF);
 }
 
+TEST_F(GraphTest, FloydWarshallBlocked) {
+    auto [dist, stats] = floyd_algorithm_blocked(small_directed_matrix, 2, 3);
+
+    EXPECT_EQ(dist[0][2], 3);
+    EXPECT_EQ(dist[1][3], 7);
+    EXPECT_EQ(dist[3][0], INF);
+
+    // tile sizes that do not divide the vertex count must match the sequential result
+    GraphMatrix graph = generate_random_graph_matrix(70, 50, 400, true);
+    auto expected = floyd_algorithm(graph).dist;
+    for (size_t tile : {1, 8, 16, 64, 128}) {
+        auto blocked = floyd_algorithm_blocked(graph, 4, tile).dist;
+        for (size_t i = 0; i < graph.num_vert; ++i)
+            for (size_t j = 0; j < graph.num_vert; ++j)
+                ASSERT_EQ(blocked[i][j], expected[i][j]) << "tile " << tile << " at " << i << "," << j;
+    }
+}
+
+TEST_F(GraphTest, JohnsonAllPairs) {
+    GraphMatrix graph = generate_random_graph_matrix(70, 50, 300, true);
+    auto expected = floyd_algorithm(graph).dist;
+    FloydResult johnson = johnson_algorithm(matrix_to_csr(graph), 3);
+    EXPECT_EQ(johnson.stats.algorithm, "johnson");
+    for (size_t i = 0; i < graph.num_vert; ++i)
+        for (size_t j = 0; j < graph.num_vert; ++j)
+            ASSERT_EQ(johnson.dist[i][j], expected[i][j]) << "at " << i << "," << j;
+
+    // negative edges are reweighted away; 0 -> 1 -> 2 is shorter than the direct edge
+    GraphMatrix negative(4);
+    add_edge_matrix(negative, 0, 1, 4);
+    add_edge_matrix(negative, 1, 2, -3);
+    add_edge_matrix(negative, 0, 2, 2);
+    add_edge_matrix(negative, 2, 3, 1);
+    Matrix dist = johnson_algorithm(matrix_to_csr(negative), 2).dist;
+    EXPECT_EQ(dist[0][2], 1);
+    EXPECT_EQ(dist[0][3], 2);
+    EXPECT_EQ(dist[1][3], -2);
+    EXPECT_EQ(dist[3][0], INF);
+
+    add_edge_matrix(negative, 2, 1, 1);
+    EXPECT_THROW(johnson_algorithm(matrix_to_csr(negative), 2), std::invalid_argument);
+
+    // E = 4V at 20k vertices is Johnson territory; a near-complete graph is Floyd's
+    EXPECT_EQ(choose_apsp_method(20000, 80000), ApspMethod::Johnson);
+    EXPECT_EQ(choose_apsp_method(100, 5000), ApspMethod::Floyd);
+}
+
+TEST_F(GraphTest, SingleSourceShortestPaths) {
+    GraphMatrix graph = generate_random_graph_matrix(70, 50, 300, true);
+    auto expected = floyd_algorithm(graph).dist;
+    GraphCSR csr = matrix_to_csr(graph);
+    std::vector<size_t> sources = { 0, 5, 69 };
+
+    SsspResult dijkstra = dijkstra_sssp(csr, sources);
+    EXPECT_EQ(dijkstra.stats.algorithm, "dijkstra");
+    for (size_t i = 0; i < sources.size(); ++i)
+        for (size_t v = 0; v < graph.num_vert; ++v)
+            ASSERT_EQ(dijkstra.row(i)[v], expected[sources[i]][v]) << "from " << sources[i] << " to " << v;
+
+    // any bucket width gives the same distances; 0 picks one
+    for (uint64_t delta : {0, 1, 7, 1000}) {
+        SsspResult stepped = delta_stepping_sssp(csr, sources, 3, delta);
+        EXPECT_GT(stepped.stats.delta, 0u);
+        EXPECT_EQ(stepped.dist, dijkstra.dist) << "delta " << delta;
+    }
+
+    // buckets large enough to be shared between threads rather than relaxed locally
+    GraphCSR large = generate_random_graph_csr(20000, 100, 100000, false, 7);
+    EXPECT_EQ(delta_stepping_sssp(large, { 3 }, 4, 2).dist, dijkstra_sssp(large, { 3 }).dist);
+
+    EXPECT_THROW(dijkstra_sssp(csr, { 70 }), std::invalid_argument);
+    EXPECT_THROW(delta_stepping_sssp(csr, {}, 2), std::invalid_argument);
+    GraphMatrix negative(2);
+    add_edge_matrix(negative, 0, 1, -1);
+    EXPECT_THROW(delta_stepping_sssp(matrix_to_csr(negative), { 0 }, 2), std::invalid_argument);
+
+    // buckets are reused cyclically, so heavy weights bound how small delta may be
+    GraphMatrix heavy(2);
+    add_edge_matrix(heavy, 0, 1, 1000000);
+    EXPECT_THROW(delta_stepping_sssp(matrix_to_csr(heavy), { 0 }, 2, 1), std::invalid_argument);
+    EXPECT_EQ(delta_stepping_sssp(matrix_to_csr(heavy), { 0 }, 2).row(0)[1], 1000000);
+}
+
+TEST_F(GraphTest, MinPlusKernels) {
+    MinPlusRowFn reference = minplus_row_kernel(SimdIsa::Scalar);
+    ASSERT_NE(reference, nullptr);
+
+    for (SimdIsa isa : {SimdIsa::SSE41, SimdIsa::AVX2, SimdIsa::AVX512}) {
+        MinPlusRowFn kernel = minplus_row_kernel(isa);
+        if (!kernel) continue; // not supported on this CPU
+
+        for (size_t n : {1, 7, 16, 37}) {
+            for (int d_ik : {0, 5, -3}) {
+                std::vector<int> row_k(n), expected(n), actual(n);
+                for (size_t j = 0; j < n; ++j) {
+                    row_k[j] = (j % 3 == 0) ? INF : static_cast<int>(j * 7 % 11);
+                    expected[j] = actual[j] = (j % 4 == 0) ? INF : static_cast<int>(j * 5 % 13);
+                }
+                reference(expected.data(), row_k.data(), d_ik, n);
+                kernel(actual.data(), row_k.data(), d_ik, n);
+                EXPECT_EQ(actual, expected) << simd_isa_name(isa) << " n=" << n << " d_ik=" << d_ik;
+            }
+        }
+    }
+
+    // INF entries stay INF even when relaxed through a negative weight
+    std::vector<int> row_i = {INF, 4}, row_k = {INF, 1};
+    minplus_row(row_i.data(), row_k.data(), -2, 2);
+    EXPECT_EQ(row_i[0], INF);
+    EXPECT_EQ(row_i[1], -1);
+}
+
 TEST_F(GraphTest, ConnectedComponentsSequential) {
     // add a disconnected vertex
     GraphAdjList test_graph = small_undirected_list;
     test_graph.num_vert = 5;
     test_graph.adjList.resize(5);
     
-    auto [components, report] = connected_components_algorithm(test_graph);
+    auto [components, stats] = connected_components_algorithm(test_graph);
     
     // should have 2 components (0-1-2-3 and 4)
     EXPECT_EQ(components.size(), 2);
@@ -110,7 +244,7 @@ TEST_F(GraphTest, ConnectedComponentsParallel) {
     test_graph.num_vert = 5;
     test_graph.adjList.resize(5);
     
-    auto [components, report] = connected_components_algorithm_parallel(test_graph, 2);
+    auto [components, stats] = connected_components_algorithm_parallel(test_graph, 2);
     
     // should have 2 components (0-1-2-3 and 4)
     EXPECT_EQ(components.size(), 2);
@@ -120,6 +254,611 @@ TEST_F(GraphTest, ConnectedComponentsParallel) {
                 (components[0].size() == 1 && components[1].size() == 4));
 }
 
+TEST_F(GraphTest, CSRConversion) {
+    GraphCSR from_list = list_to_csr(small_undirected_list);
+    EXPECT_TRUE(from_list.valid);
+    EXPECT_EQ(from_list.num_vert, 4u);
+    EXPECT_EQ(from_list.num_edges(), 4u); // edges were added as directed
+    EXPECT_EQ(from_list.degree(0), 2u);
+    EXPECT_EQ(from_list.neighbors[from_list.offsets[0]], 1u);
+    EXPECT_EQ(from_list.weights[from_list.offsets[0]], 2);
+
+    GraphCSR64 from_matrix = matrix_to_csr<uint64_t>(small_directed_matrix);
+    EXPECT_EQ(from_matrix.num_edges(), 5u); // diagonal is not an edge
+    EXPECT_EQ(from_matrix.degree(2), 2u);
+    EXPECT_EQ(from_matrix.neighbors[from_matrix.offsets[2]], 0u);
+    EXPECT_EQ(from_matrix.weights[from_matrix.offsets[2] + 1], 5);
+
+    EXPECT_FALSE(list_to_csr(GraphAdjList()).valid);
+}
+
+TEST_F(GraphTest, ConnectedComponentsCSR) {
+    GraphAdjList list(6);
+    add_edge_adjList(list, 0, 1, 1, 0, false);
+    add_edge_adjList(list, 1, 2, 1, 0, false);
+    add_edge_adjList(list, 4, 5, 1, 0, false);
+    GraphCSR csr = list_to_csr(list);
+
+    auto [seq, seq_stats] = connected_components_algorithm(csr);
+    auto [par, par_stats] = connected_components_algorithm_parallel(csr, 2);
+    EXPECT_EQ(seq.size(), 3u); // {0,1,2}, {3}, {4,5}
+    EXPECT_EQ(par.size(), 3u);
+}
+
+TEST_F(GraphTest, ComponentsFromLabels) {
+    // representatives label themselves: components {0,2,5}, {1,4}, {3}
+    std::vector<uint32_t> labels = {0, 1, 0, 3, 1, 0};
+    ComponentList components = components_from_labels(labels);
+
+    ASSERT_EQ(components.size(), 3u);
+    EXPECT_EQ(components.vertices, (std::vector<int>{0, 2, 5, 1, 4, 3}));
+    EXPECT_EQ(components.offsets, (std::vector<size_t>{0, 3, 5, 6}));
+    EXPECT_EQ(components.largest_size(), 3u);
+
+    // more than 256 components needs several radix passes; the result must not depend on threads
+    GraphAdjList sparse = generate_random_graph_list(3000, 10, 1000, false);
+    auto [two, stats2] = connected_components_algorithm_parallel(sparse, 2);
+    auto [four, stats4] = connected_components_algorithm_parallel(sparse, 4);
+    EXPECT_GT(two.size(), 256u);
+    EXPECT_EQ(two.vertices, four.vertices);
+    EXPECT_EQ(two.offsets, four.offsets);
+    EXPECT_EQ(two.size(), connected_components_algorithm(sparse).components.size());
+    for (size_t c = 0; c < two.size(); ++c)
+        EXPECT_TRUE(std::is_sorted(two[c].begin(), two[c].end()));
+}
+
+TEST_F(GraphTest, ConnectedComponentsAfforest) {
+    GraphCSR csr = list_to_csr(generate_random_graph_list(2000, 10, 1500, false));
+    auto expected = connected_components_algorithm_parallel(csr, 2).components;
+
+    for (int rounds : {0, 1, 2, 5}) {
+        auto [components, stats] = connected_components_afforest(csr, 4, rounds);
+        EXPECT_EQ(components.vertices, expected.vertices) << "rounds " << rounds;
+        EXPECT_EQ(components.offsets, expected.offsets) << "rounds " << rounds;
+    }
+
+    // a power-law graph has a giant component, whose vertices the finish phase skips
+    GraphCSR rmat = generate_graph_csr(GraphGenerator::Rmat, 32768, 10, 262144, false, 5);
+    auto rmat_expected = connected_components_algorithm_parallel(rmat, 2).components;
+    auto [rmat_components, rmat_stats] = connected_components_afforest(rmat, 4, 2);
+    EXPECT_GT(rmat_stats.giant_fraction, 0.5);
+    EXPECT_GT(rmat_stats.skipped_vertices, 0u);
+    EXPECT_EQ(rmat_components.vertices, rmat_expected.vertices);
+    EXPECT_EQ(rmat_components.offsets, rmat_expected.offsets);
+
+    GraphCSR empty(0);
+    EXPECT_EQ(connected_components_afforest(empty, 2).components.size(), 0u);
+}
+
+TEST_F(GraphTest, ConnectedComponentsLongChain) {
+    // a path this long used to overflow the stack of the recursive DFS
+    const size_t n = 500000;
+    GraphCSR chain(n);
+    for (size_t v = 0; v < n; ++v) {
+        if (v > 0) { chain.neighbors.push_back(v - 1); chain.weights.push_back(1); }
+        if (v + 1 < n) { chain.neighbors.push_back(v + 1); chain.weights.push_back(1); }
+        chain.offsets[v + 1] = chain.neighbors.size();
+    }
+
+    auto [components, stats] = connected_components_algorithm(chain);
+    ASSERT_EQ(components.size(), 1u);
+    EXPECT_EQ(components[0].size(), n);
+    EXPECT_EQ(components[0][0], 0);
+    EXPECT_EQ(components[0][n - 1], static_cast<int>(n - 1));
+}
+
+TEST_F(GraphTest, GraphStoreLRU) {
+    auto matrix = std::make_shared<const GraphMatrix>(GraphMatrix(16));
+    StoredGraph graph{ matrix, nullptr };
+    const size_t bytes = graph.memory_bytes();
+
+    GraphStore store(2 * bytes);
+    std::string a = store.put(graph);
+    std::string b = store.put(graph);
+
+    StoredGraph out;
+    ASSERT_TRUE(store.get(a, out)); // a becomes most recently used
+    EXPECT_EQ(out.num_vert(), 16u);
+
+    std::string c = store.put(graph); // evicts b, the least recently used
+    EXPECT_TRUE(store.get(a, out));
+    EXPECT_FALSE(store.get(b, out));
+    EXPECT_TRUE(store.get(c, out));
+    EXPECT_EQ(store.memory_used(), 2 * bytes);
+
+    EXPECT_TRUE(store.erase(a));
+    EXPECT_EQ(store.memory_used(), bytes);
+
+    GraphStore tiny(bytes / 2);
+    EXPECT_THROW(tiny.put(graph), std::length_error);
+
+    // derived representations
+    EXPECT_EQ(stored_csr(graph)->num_vert, 16u);
+    EXPECT_EQ(stored_matrix(StoredGraph{ nullptr, stored_csr(graph) })->weight_matrix[3][3], 0);
+
+    // a stored graph converts once and counts the derived form against its entry
+    GraphStore cache(4 * bytes);
+    std::string d = cache.put(graph);
+    ASSERT_TRUE(cache.get(d, out));
+    auto derived = stored_csr(out);
+    EXPECT_EQ(stored_csr(out), derived);
+    StoredGraph again;
+    ASSERT_TRUE(cache.get(d, again));
+    EXPECT_EQ(stored_csr(again), derived);
+    EXPECT_EQ(cache.memory_used(), bytes + derived->owned_bytes());
+    EXPECT_EQ(cache.list().front().memory_bytes, cache.memory_used());
+}
+
+TEST_F(GraphTest, GraphBlobRoundTrip) {
+    GraphMatrix matrix = generate_random_graph_matrix(37, 10, 200, true);
+    std::vector<uint8_t> matrix_blob = encode_matrix_blob(matrix);
+    EXPECT_EQ(matrix_blob.size(), 12u + 37 * 37 * 4);
+    GraphMatrix decoded = decode_matrix_blob(matrix_blob.data(), matrix_blob.size());
+    ASSERT_EQ(decoded.num_vert, 37u);
+    for (size_t i = 0; i < 37; ++i)
+        for (size_t j = 0; j < 37; ++j)
+            EXPECT_EQ(decoded.weight_matrix[i][j], matrix.weight_matrix[i][j]);
+
+    GraphCSR csr = list_to_csr(small_undirected_list);
+    std::vector<uint8_t> csr_blob = encode_csr_blob(csr);
+    GraphCSR csr_decoded = decode_csr_blob(csr_blob.data(), csr_blob.size());
+    EXPECT_EQ(csr_decoded.offsets, csr.offsets);
+    EXPECT_EQ(csr_decoded.neighbors, csr.neighbors);
+    EXPECT_EQ(csr_decoded.weights, csr.weights);
+
+    EXPECT_THROW(decode_matrix_blob(matrix_blob.data(), matrix_blob.size() - 1), std::invalid_argument);
+    EXPECT_THROW(decode_csr_blob(csr_blob.data(), csr_blob.size() - 1), std::invalid_argument);
+    EXPECT_THROW(decode_csr_blob(matrix_blob.data(), matrix_blob.size()), std::invalid_argument);
+    csr_blob[csr_blob.size() - csr.num_edges() * 8] = 0xff; // first neighbor out of range
+    EXPECT_THROW(decode_csr_blob(csr_blob.data(), csr_blob.size()), std::out_of_range);
+    for (int i = 0; i < 4; ++i)
+        matrix_blob[12 + i] = static_cast<uint8_t>(1500000000u >> (8 * i)); // first cell past INF
+    EXPECT_THROW(decode_matrix_blob(matrix_blob.data(), matrix_blob.size()), std::out_of_range);
+}
+
+TEST_F(GraphTest, GraphFileMapping) {
+    GraphMatrix matrix = generate_random_graph_matrix(50, 10, 300, false);
+    const std::string path = ::testing::TempDir() + "graph_file_test.pgraph";
+
+    GraphFileInfo saved = save_graph_file(path, StoredGraph{ std::make_shared<const GraphMatrix>(matrix), nullptr }, true);
+    EXPECT_TRUE(saved.has_matrix);
+
+    GraphFileInfo info;
+    StoredGraph loaded = load_graph_file(path, &info);
+    EXPECT_EQ(info.num_vert, 50u);
+    EXPECT_EQ(info.num_edges, saved.num_edges);
+    ASSERT_TRUE(loaded.csr && loaded.matrix);
+    EXPECT_TRUE(loaded.csr->neighbors.is_view());
+    EXPECT_TRUE(loaded.matrix->weight_matrix.is_view());
+    EXPECT_EQ(loaded.memory_bytes(), 0u);
+
+    GraphCSR csr = matrix_to_csr(matrix);
+    EXPECT_EQ(loaded.csr->offsets, csr.offsets);
+    EXPECT_EQ(loaded.csr->neighbors, csr.neighbors);
+    EXPECT_EQ(loaded.csr->weights, csr.weights);
+
+    // algorithms read the mapping in place and give the same answers
+    EXPECT_EQ(floyd_algorithm_blocked(*loaded.matrix, 2).dist.view()[3][7],
+              floyd_algorithm_blocked(matrix, 2).dist.view()[3][7]);
+    EXPECT_EQ(connected_components_algorithm(*loaded.csr).components.vertices,
+              connected_components_algorithm(csr).components.vertices);
+
+    // copies own their data, so writing to one leaves the mapping alone
+    GraphCSR copy = *loaded.csr;
+    EXPECT_FALSE(copy.weights.is_view());
+    copy.weights[0] = -5;
+    EXPECT_EQ(loaded.csr->weights[0], csr.weights[0]);
+
+    // rewriting a file that is still mapped must not disturb the existing mapping
+    save_graph_file(path, loaded, false);
+    StoredGraph csr_only = load_graph_file(path);
+    EXPECT_EQ(loaded.matrix->weight_matrix[3][7], matrix.weight_matrix[3][7]);
+    EXPECT_FALSE(csr_only.matrix);
+    EXPECT_EQ(stored_matrix(csr_only)->weight_matrix[3][7], matrix.weight_matrix[3][7]);
+
+    std::remove(path.c_str());
+    EXPECT_THROW(load_graph_file(path), std::runtime_error);
+}
+
+TEST_F(GraphTest, SeededGraphGeneration) {
+    // the same seed gives the same graph for any thread count
+    GraphCSR base = generate_random_graph_csr(500, 20, 3000, false, 42, 1);
+    for (int threads : {2, 5}) {
+        GraphCSR again = generate_random_graph_csr(500, 20, 3000, false, 42, threads);
+        EXPECT_EQ(again.offsets, base.offsets);
+        EXPECT_EQ(again.neighbors, base.neighbors);
+        EXPECT_EQ(again.weights, base.weights);
+    }
+    EXPECT_NE(generate_random_graph_csr(500, 20, 3000, false, 43, 1).neighbors, base.neighbors);
+
+    // exact edge counts without self loops or duplicates; undirected edges are mirrored
+    // with the same weight. 60 of 66 pairs takes the dense (complement) path
+    for (bool directed : {false, true}) {
+        for (uint64_t edges : {uint64_t(0), uint64_t(25), uint64_t(60)}) {
+            GraphCSR csr = generate_random_graph_csr(12, 9, edges, directed, 7, 3);
+            ASSERT_TRUE(csr.valid);
+            EXPECT_EQ(csr.num_edges(), directed ? edges : 2 * edges);
+            GraphMatrix matrix = csr_to_matrix(csr);
+            EXPECT_EQ(matrix_to_csr(matrix).num_edges(), csr.num_edges());
+            for (size_t u = 0; u < 12; u++) {
+                EXPECT_EQ(matrix.weight_matrix[u][u], 0);
+                for (uint64_t e = csr.offsets[u]; e < csr.offsets[u + 1]; e++) {
+                    EXPECT_GE(csr.weights[e], 1);
+                    EXPECT_LE(csr.weights[e], 9);
+                    if (!directed) {
+                        EXPECT_EQ(matrix.weight_matrix[csr.neighbors[e]][u], csr.weights[e]);
+                    }
+                }
+            }
+        }
+    }
+
+    EXPECT_EQ(generate_random_graph_csr(12, 9, 66, false, 1).num_edges(), 132u);
+    EXPECT_THROW(generate_random_graph_csr(12, 9, 67, false, 1), std::invalid_argument);
+    EXPECT_THROW(generate_random_graph_csr(1, 9, 1, true, 1), std::invalid_argument);
+    EXPECT_THROW(generate_random_graph_csr(12, 0, 5, false, 1), std::invalid_argument);
+}
+
+TEST_F(GraphTest, GraphFamilies) {
+    auto max_degree = [](const GraphCSR& csr) {
+        size_t d = 0;
+        for (size_t v = 0; v < csr.num_vert; v++) d = std::max(d, csr.degree(v));
+        return d;
+    };
+
+    for (const char* name : {"rmat", "ba", "grid", "chain"}) {
+        GraphGenerator generator = graph_generator(name);
+        GraphCSR csr = generate_graph_csr(generator, 1000, 9, 8000, false, 11, 1);
+        GraphCSR again = generate_graph_csr(generator, 1000, 9, 8000, false, 11, 3);
+        EXPECT_EQ(again.neighbors, csr.neighbors) << name;
+        EXPECT_EQ(again.weights, csr.weights) << name;
+
+        // simple and symmetric: rows strictly increasing, no self loops, mirrored weights
+        GraphMatrix matrix = csr_to_matrix(csr);
+        for (size_t u = 0; u < csr.num_vert; u++) {
+            for (uint64_t e = csr.offsets[u]; e < csr.offsets[u + 1]; e++) {
+                EXPECT_NE(csr.neighbors[e], u) << name;
+                if (e > csr.offsets[u]) {
+                    EXPECT_LT(csr.neighbors[e - 1], csr.neighbors[e]) << name;
+                }
+                EXPECT_EQ(matrix.weight_matrix[csr.neighbors[e]][u], csr.weights[e]) << name;
+            }
+        }
+    }
+
+    // skewed families have hubs far above the average degree of about 16
+    EXPECT_GT(max_degree(generate_graph_csr(GraphGenerator::Rmat, 4096, 9, 32768, false, 3)), 200u);
+    GraphCSR ba = generate_graph_csr(GraphGenerator::BarabasiAlbert, 4096, 9, 32768, false, 3);
+    EXPECT_GT(max_degree(ba), 150u);
+    EXPECT_EQ(connected_components_algorithm(ba).components.size(), 1u);
+
+    // 1000 vertices hold at most 499500 undirected edges, whatever the family
+    EXPECT_THROW(generate_graph_csr(GraphGenerator::Rmat, 1000, 9, 1000000000, false, 3), std::invalid_argument);
+    EXPECT_THROW(generate_graph_csr(GraphGenerator::BarabasiAlbert, 1000, 9, 499501, false, 3), std::invalid_argument);
+
+    GraphCSR grid = generate_graph_csr(GraphGenerator::Grid, 12, 9, 0, false, 3);
+    EXPECT_EQ(grid.num_edges(), 2u * (9 + 8));
+    GraphCSR chain = generate_graph_csr(GraphGenerator::Chain, 50, 9, 0, true, 3);
+    EXPECT_EQ(chain.num_edges(), 49u);
+    EXPECT_EQ(chain.neighbors[0], 1u);
+    EXPECT_EQ(connected_components_algorithm(chain).components.size(), 1u);
+    EXPECT_THROW(graph_generator("smallworld"), std::invalid_argument);
+}
+
+TEST_F(GraphTest, EdgeListLoaders) {
+    const std::string path = ::testing::TempDir() + "edge_list_test";
+    auto write = [&](const std::string& text) { std::ofstream(path, std::ios::binary) << text; };
+
+    // SNAP: 0-based, comments, optional weights, ids size the graph
+    write("# comment\n0 1 5\n2\t0\n\n% also a comment\n1 3 2\n0 1 4\r\n3 3\n1 0 7");
+    for (int threads : {1, 3}) {
+        GraphCSR csr = load_edge_list(path, EdgeListFormat::Snap, false, threads);
+        EXPECT_EQ(csr.num_vert, 4u);
+        EXPECT_EQ(csr.offsets, std::vector<uint64_t>({0, 2, 4, 5, 5}));
+        EXPECT_EQ(csr.neighbors, std::vector<uint32_t>({1, 1, 0, 3, 0}));
+        EXPECT_EQ(csr.weights, std::vector<int>({4, 5, 7, 2, 1}));
+    }
+
+    // symmetrizing adds reverse edges and keeps the lightest duplicate
+    GraphCSR sym = load_edge_list(path, EdgeListFormat::Snap, true, 2);
+    EXPECT_EQ(sym.offsets, std::vector<uint64_t>({0, 2, 4, 5, 6}));
+    EXPECT_EQ(sym.neighbors, std::vector<uint32_t>({1, 2, 0, 3, 0, 1}));
+    EXPECT_EQ(sym.weights, std::vector<int>({4, 1, 4, 2, 1, 2}));
+
+    // Matrix Market: 1-based, symmetric files are mirrored, real values rounded
+    write("%%MatrixMarket matrix coordinate real symmetric\n% c\n5 5 3\n2 1 1.6\n3 1 2.5e1\n5 4 -3\n");
+    GraphCSR mtx = load_edge_list(path, EdgeListFormat::MatrixMarket, false, 2);
+    EXPECT_EQ(mtx.num_vert, 5u);
+    EXPECT_EQ(mtx.offsets, std::vector<uint64_t>({0, 2, 3, 4, 5, 6}));
+    EXPECT_EQ(mtx.neighbors, std::vector<uint32_t>({1, 2, 0, 0, 4, 3}));
+    EXPECT_EQ(mtx.weights, std::vector<int>({2, 25, 2, 25, -3, -3}));
+
+    // DIMACS: "p" line sizes the graph, "a" arcs carry weights
+    write("c shortest path\np sp 4 3\na 1 2 10\na 2 3 20\nc mid\na 4 1 5\n");
+    GraphCSR gr = load_edge_list(path, EdgeListFormat::Dimacs, false, 4);
+    EXPECT_EQ(gr.num_vert, 4u);
+    EXPECT_EQ(gr.neighbors, std::vector<uint32_t>({1, 2, 0}));
+    EXPECT_EQ(gr.weights, std::vector<int>({10, 20, 5}));
+
+    write("p sp 2 1\na 1 3 1\n");
+    EXPECT_THROW(load_edge_list(path, EdgeListFormat::Dimacs), std::out_of_range);
+    // header sizes past 32-bit ids are refused before anything is allocated
+    write("p sp 5000000000 1\na 1 2 1\n");
+    EXPECT_THROW(load_edge_list(path, EdgeListFormat::Dimacs), std::out_of_range);
+    write("%%MatrixMarket matrix coordinate pattern general\n5000000000 5000000000 1\n1 2\n");
+    EXPECT_THROW(load_edge_list(path, EdgeListFormat::MatrixMarket), std::out_of_range);
+    write("0 x\n");
+    EXPECT_THROW(load_edge_list(path, EdgeListFormat::Snap), std::invalid_argument);
+    EXPECT_EQ(edge_list_format("web-Google.txt"), EdgeListFormat::Snap);
+    EXPECT_EQ(edge_list_format("road.gr"), EdgeListFormat::Dimacs);
+    EXPECT_THROW(edge_list_format("graph.bin"), std::invalid_argument);
+    std::remove(path.c_str());
+}
+
+TEST_F(GraphTest, StreamingGraphIngest) {
+    using nlohmann::json;
+    const json::input_format_t JSON = json::input_format_t::json;
+
+    StoredGraph graph;
+    json options = parse_graph_request(
+        R"({"num_threads": 2, "matrix": [[0, 4, null], [null, 0, 1], [2, null, 0]], "extra": {"a": [1, {"b": true}]}})",
+        JSON, graph);
+    ASSERT_TRUE(graph.matrix);
+    EXPECT_FALSE(graph.csr);
+    EXPECT_EQ(graph.matrix->num_vert, 3u);
+    EXPECT_EQ(graph.matrix->weight_matrix[0][1], 4);
+    EXPECT_EQ(graph.matrix->weight_matrix[0][2], INF);
+    EXPECT_EQ(graph.matrix->weight_matrix[2][0], 2);
+    EXPECT_FALSE(options.contains("matrix"));
+    EXPECT_EQ(options.at("num_threads").get<int>(), 2);
+    EXPECT_EQ(options.at("extra"), json::parse(R"({"a": [1, {"b": true}]})"));
+
+    StoredGraph list;
+    parse_graph_request(R"({"adjList": [[{"weight": 3, "to": 1}], [{"to": 0, "weight": 3}], []]})", JSON, list);
+    ASSERT_TRUE(list.csr);
+    EXPECT_EQ(list.csr->num_vert, 3u);
+    EXPECT_EQ(list.csr->offsets, (std::vector<uint64_t>{0, 1, 2, 2}));
+    EXPECT_EQ(list.csr->neighbors, (std::vector<uint32_t>{1, 0}));
+    EXPECT_EQ(list.csr->weights, (std::vector<int>{3, 3}));
+
+    // binary formats carry the graph as a blob that is decoded in place
+    json binary_request = {{"csr", json::binary(encode_csr_blob(*list.csr))}, {"mode", "blocked"}};
+    std::vector<uint8_t> cbor = json::to_cbor(binary_request);
+    StoredGraph from_cbor;
+    options = parse_graph_request(std::string(cbor.begin(), cbor.end()), json::input_format_t::cbor, from_cbor);
+    ASSERT_TRUE(from_cbor.csr);
+    EXPECT_EQ(from_cbor.csr->neighbors, list.csr->neighbors);
+    EXPECT_EQ(options.at("mode"), "blocked");
+
+    StoredGraph bad;
+    EXPECT_THROW(parse_graph_request(R"({"matrix": [[0, 1], [1]]})", JSON, bad), std::invalid_argument);
+    EXPECT_THROW(parse_graph_request(R"({"matrix": [[0, 1], [1, 0], [0, 0]]})", JSON, bad), std::invalid_argument);
+    EXPECT_THROW(parse_graph_request(R"({"matrix": [[0, "x"], [1, 0]]})", JSON, bad), std::invalid_argument);
+    EXPECT_THROW(parse_graph_request(R"({"adjList": [[{"to": 5, "weight": 1}]]})", JSON, bad), std::out_of_range);
+    EXPECT_THROW(parse_graph_request(R"({"adjList": [[{"to": 0}]]})", JSON, bad), std::invalid_argument);
+    // weights at or past INF would overflow the min-plus sums
+    EXPECT_THROW(parse_graph_request(R"({"matrix": [[0, 1500000000], [1, 0]]})", JSON, bad), std::out_of_range);
+    EXPECT_THROW(parse_graph_request(R"({"matrix": [[0, 1e300], [1, 0]]})", JSON, bad), std::out_of_range);
+    EXPECT_THROW(parse_graph_request(R"({"adjList": [[{"to": 0, "weight": -2e9}]]})", JSON, bad), std::out_of_range);
+    EXPECT_THROW(parse_graph_request(R"({"matrix": [[0]], "adjList": [[]]})", JSON, bad), std::invalid_argument);
+    EXPECT_THROW(parse_graph_request(R"({"matrix": [[0]])", JSON, bad), std::invalid_argument);
+}
+
+TEST_F(GraphTest, ProgressAndCancellation) {
+    GraphMatrix matrix = generate_random_graph_matrix(64, 10, 400, false);
+    GraphCSR csr = matrix_to_csr(matrix);
+
+    ProgressControl progress;
+    floyd_algorithm_blocked(matrix, 2, 16, &progress);
+    EXPECT_EQ(progress.done.load(), 64u);
+    EXPECT_DOUBLE_EQ(progress.fraction(), 1.0);
+
+    connected_components_algorithm_parallel(csr, 2, &progress);
+    EXPECT_EQ(progress.done.load(), csr.num_edges());
+    connected_components_algorithm(csr, &progress);
+    EXPECT_EQ(progress.done.load(), csr.num_edges());
+
+    ProgressControl cancelled;
+    cancelled.cancel();
+    EXPECT_THROW(floyd_algorithm(matrix, &cancelled), OperationCancelled);
+    EXPECT_THROW(floyd_algorithm_parallel(matrix, 2, &cancelled), OperationCancelled);
+    EXPECT_THROW(connected_components_afforest(csr, 2, 2, &cancelled), OperationCancelled);
+}
+
+// polls until the job leaves the queued/running states
+static JobInfo wait_for_job(JobQueue& queue, const std::string& id) {
+    JobInfo info;
+    for (int i = 0; i < 2000; ++i) {
+        queue.info(id, info);
+        if (info.state != JobState::Queued && info.state != JobState::Running)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return info;
+}
+
+TEST_F(GraphTest, JobQueue) {
+    JobQueue queue(1, 2, 8);
+
+    // the single worker is held by a job that runs until cancelled
+    std::string blocker = queue.submit("spin", [](ProgressControl& progress) {
+        progress.start(1);
+        while (!progress.cancelled())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        throw_if_cancelled(&progress);
+        return std::string();
+    });
+    JobInfo info;
+    while (queue.info(blocker, info) && info.state == JobState::Queued)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    std::string done = queue.submit("answer", [](ProgressControl&) { return std::string("42"); });
+    std::string dropped = queue.submit("never", [](ProgressControl&) { return std::string("x"); });
+    EXPECT_THROW(queue.submit("overflow", [](ProgressControl&) { return std::string(); }), std::length_error);
+
+    EXPECT_TRUE(queue.cancel(dropped));
+    ASSERT_TRUE(queue.info(dropped, info));
+    EXPECT_EQ(info.state, JobState::Cancelled);
+
+    EXPECT_TRUE(queue.cancel(blocker));
+    EXPECT_EQ(wait_for_job(queue, blocker).state, JobState::Cancelled);
+    EXPECT_EQ(wait_for_job(queue, done).state, JobState::Done);
+
+    std::string body;
+    EXPECT_TRUE(queue.result(done, body));
+    EXPECT_EQ(body, "42");
+    EXPECT_FALSE(queue.result(blocker, body));
+    EXPECT_FALSE(queue.cancel("j999"));
+
+    std::string failed = queue.submit("throws", [](ProgressControl&) -> std::string { throw std::runtime_error("boom"); });
+    info = wait_for_job(queue, failed);
+    EXPECT_EQ(info.state, JobState::Failed);
+    EXPECT_EQ(info.error, "boom");
+}
+
+TEST_F(GraphTest, HardwareCounters) {
+    ProgressControl quiet;
+    auto plain = floyd_algorithm(small_directed_matrix, &quiet);
+    EXPECT_FALSE(quiet.counters.collected);
+    EXPECT_EQ(floyd_report(small_directed_matrix, plain).find("Hardware counters"), std::string::npos);
+
+    // counted or not, the run succeeds; without perf support the report says why
+    ProgressControl progress;
+    progress.collect_counters = true;
+    auto result = connected_components_algorithm_parallel(list_to_csr(small_undirected_list), 2, &progress);
+    const PerfCounts& counts = progress.counters;
+    EXPECT_TRUE(counts.collected);
+    EXPECT_EQ(counts.threads, thread_budget().team_size(2));
+    EXPECT_TRUE(counts.available != 0 || !counts.reason.empty());
+    EXPECT_NE(components_report(result).find("Hardware counters"), std::string::npos);
+    if (counts.has(PERF_INSTRUCTIONS)) {
+        EXPECT_GT(counts.values[PERF_INSTRUCTIONS], 0u);
+    }
+}
+
+TEST_F(GraphTest, RunStatsReports) {
+    // runs only measure; the text comes from the stats when asked for
+    FloydResult floyd = floyd_algorithm_blocked(small_directed_matrix, 2, 3);
+    EXPECT_EQ(floyd.stats.algorithm, "floyd_blocked");
+    EXPECT_EQ(floyd.stats.num_vert, small_directed_matrix.num_vert);
+    EXPECT_EQ(floyd.stats.tile_size, 3u);
+    EXPECT_EQ(floyd.stats.threads, thread_budget().team_size(2));
+    EXPECT_GE(floyd.stats.total_ms, floyd.stats.kernel_ms);
+    std::string floyd_text = floyd_report(small_directed_matrix, floyd);
+    EXPECT_NE(floyd_text.find("Blocked Parallel Floyd-Warshall"), std::string::npos);
+    EXPECT_NE(floyd_text.find("Final shortest paths matrix"), std::string::npos);
+
+    ComponentsResult cc = connected_components_afforest(list_to_csr(small_undirected_list), 2, 1);
+    EXPECT_EQ(cc.stats.algorithm, "cc_afforest");
+    EXPECT_EQ(cc.stats.neighbor_rounds, 1);
+    EXPECT_EQ(cc.stats.num_edges, list_to_csr(small_undirected_list).num_edges() / 2);
+    std::string cc_text = components_report(cc);
+    EXPECT_NE(cc_text.find("Number of components: " + std::to_string(cc.components.size())), std::string::npos);
+    EXPECT_NE(components_report(connected_components_algorithm(small_undirected_list)).find("BFS-based"),
+              std::string::npos);
+}
+
+TEST_F(GraphTest, TraceSpans) {
+    set_tracing(false);
+    clear_trace();
+    { TraceSpan ignored("ignored"); }
+    EXPECT_EQ(trace_event_count(), 0u);
+
+    set_tracing(true);
+    connected_components_algorithm_parallel(list_to_csr(small_undirected_list), 2);
+    floyd_algorithm(small_directed_matrix);
+    set_tracing(false);
+
+    std::string trace = trace_chrome_json();
+    EXPECT_GT(trace_event_count(), 0u);
+    EXPECT_NE(trace.find("\"cc_parallel.union_worker\""), std::string::npos);
+    EXPECT_NE(trace.find("\"components.sort\""), std::string::npos);
+    EXPECT_NE(trace.find("\"floyd.kernel\""), std::string::npos);
+    EXPECT_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+
+    clear_trace();
+    EXPECT_EQ(trace_event_count(), 0u);
+}
+
+TEST_F(GraphTest, MetricsExposition) {
+    // every value lands in a bucket whose bounds hold it, within 12.5%
+    for (uint64_t us : {0ull, 7ull, 8ull, 15ull, 16ull, 1000ull, 123456789ull}) {
+        int b = LatencyHistogram::bucket_of(us);
+        EXPECT_LE(LatencyHistogram::bucket_lower(b), us);
+        EXPECT_LT(us, LatencyHistogram::bucket_upper(b));
+        EXPECT_LE(LatencyHistogram::bucket_upper(b) - LatencyHistogram::bucket_lower(b),
+                  std::max<uint64_t>(1, LatencyHistogram::bucket_lower(b) / 8));
+    }
+    EXPECT_EQ(LatencyHistogram::bucket_of(~0ull), LatencyHistogram::BUCKETS - 1);
+
+    MetricsRegistry registry;
+    RequestMetrics& floyd = registry.endpoint("POST", "/floyd");
+    EXPECT_EQ(&floyd, &registry.endpoint("POST", "/floyd"));
+
+    // 99 fast requests and one slow one, spread over threads
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&floyd, t] {
+            for (int i = t; i < 100; i += 4) {
+                floyd.requests.add();
+                floyd.latency.record(i == 99 ? 2.0 : 0.001);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    floyd.errors.add();
+    floyd.bytes_out.add(512);
+
+    LatencyHistogram::Snapshot snap = floyd.latency.snapshot();
+    EXPECT_EQ(snap.count, 100u);
+    EXPECT_NEAR(snap.sum_seconds, 99 * 0.001 + 2.0, 1e-6);
+    EXPECT_NEAR(snap.quantile(0.5), 0.001, 0.001 / 8);
+    EXPECT_NEAR(snap.quantile(0.999), 2.0, 2.0 / 8);
+
+    registry.algorithm("cc_afforest").runs.add();
+    std::string text = registry.prometheus({{"graph_jobs_pending", "Jobs waiting.", 3}});
+    EXPECT_NE(text.find("graph_http_requests_total{method=\"POST\",endpoint=\"/floyd\"} 100\n"), std::string::npos);
+    EXPECT_NE(text.find("graph_http_errors_total{method=\"POST\",endpoint=\"/floyd\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("graph_http_response_bytes_total{method=\"POST\",endpoint=\"/floyd\"} 512\n"), std::string::npos);
+    EXPECT_NE(text.find("graph_http_request_duration_seconds_bucket{method=\"POST\",endpoint=\"/floyd\",le=\"+Inf\"} 100\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE graph_http_request_duration_seconds histogram"), std::string::npos);
+    EXPECT_NE(text.find("graph_algorithm_runs_total{algorithm=\"cc_afforest\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("graph_jobs_pending 3\n"), std::string::npos);
+}
+
+TEST_F(GraphTest, ThreadBudget) {
+    ThreadBudget budget(4);
+    EXPECT_EQ(budget.acquire(0), 4);
+    budget.release(4);
+
+    int first = budget.acquire(3);
+    EXPECT_EQ(first, 3);
+    EXPECT_EQ(budget.in_use(), 3);
+
+    // a second team of three must wait until the first one is returned
+    std::atomic<bool> admitted{false};
+    std::thread waiter([&] {
+        ThreadTeam second(3, budget);
+        admitted = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(admitted.load());
+    budget.release(first);
+    waiter.join();
+    EXPECT_TRUE(admitted.load());
+    EXPECT_EQ(budget.in_use(), 0);
+
+#ifdef _OPENMP
+    // algorithms must not leave their team size behind on the calling thread
+    int before = omp_get_max_threads();
+    floyd_algorithm_parallel(small_directed_matrix, 2);
+    connected_components_algorithm_parallel(small_undirected_list, 3);
+    EXPECT_EQ(omp_get_max_threads(), before);
+#endif
+    EXPECT_EQ(thread_budget().in_use(), 0);
+}
+
 TEST_F(GraphTest, AlgorithmComparison) {
     auto [comparison, details] = compare_algorithms(small_directed_matrix, small_undirected_list, 2);
     
@@ -132,6 +871,69 @@ TEST_F(GraphTest, AlgorithmComparison) {
     EXPECT_TRUE(comparison.find("CONNECTED COMPONENTS") != std::string::npos);
 }
 
+TEST_F(GraphTest, ComparisonTimings) {
+    // the median of 1..9 is 5; with 9 trials its 95% interval is the whole sample
+    TimingSummary summary = summarize_timings({ 9, 1, 8, 2, 7, 3, 6, 4, 5 });
+    EXPECT_EQ(summary.trials, 9u);
+    EXPECT_DOUBLE_EQ(summary.min_ms, 1.0);
+    EXPECT_DOUBLE_EQ(summary.median_ms, 5.0);
+    EXPECT_DOUBLE_EQ(summary.median_low_ms, 1.0);
+    EXPECT_DOUBLE_EQ(summary.median_high_ms, 9.0);
+    EXPECT_THROW(summarize_timings({}), std::invalid_argument);
+
+    std::vector<VariantTiming> timings;
+    auto [comparison, details] = compare_algorithms(small_directed_matrix, small_undirected_list, 2,
+                                                    DEFAULT_FLOYD_TILE_SIZE, 0, 3, &timings);
+    ASSERT_EQ(timings.size(), 5u);
+    for (const VariantTiming& t : timings) {
+        EXPECT_TRUE(t.matches_sequential) << t.name;
+        EXPECT_EQ(t.kernel.trials, 3u);
+        EXPECT_LE(t.kernel.median_low_ms, t.kernel.median_high_ms);
+    }
+    EXPECT_TRUE(comparison.find("Results match sequential: yes") != std::string::npos);
+    EXPECT_THROW(compare_algorithms(small_directed_matrix, small_undirected_list, 2, DEFAULT_FLOYD_TILE_SIZE, 0, 0),
+                 std::invalid_argument);
+}
+
+TEST_F(GraphTest, ScalingSweep) {
+    EXPECT_EQ(scaling_thread_counts(1), std::vector<int>({ 1 }));
+    EXPECT_EQ(scaling_thread_counts(6), std::vector<int>({ 1, 2, 4, 6 }));
+    EXPECT_EQ(scaling_thread_counts(8), std::vector<int>({ 1, 2, 4, 8 }));
+
+    StoredGraph stored;
+    stored.csr = std::make_shared<const GraphCSR>(list_to_csr(small_undirected_list));
+    auto strong = strong_scaling(stored, { "cc", "cc_parallel", "delta_stepping" }, { 2 }, 0, 2);
+    ASSERT_EQ(strong.size(), 3u);
+    EXPECT_EQ(strong[0].points.size(), 1u); // sequential: the one-thread baseline only
+    EXPECT_EQ(strong[1].points.front().threads, 1);
+    EXPECT_EQ(strong[1].points.size(), thread_budget().capacity() > 1 ? 2u : 1u);
+    EXPECT_THROW(strong_scaling(stored, { "bellman_ford" }, {}, 0, 1), std::invalid_argument);
+
+    // weak scaling grows connected components linearly and floyd by the cube root
+    WeakScalingGraph base;
+    base.num_vert = 64;
+    base.num_edges = 128;
+    base.floyd_num_vert = 16;
+    auto weak = weak_scaling(base, { "cc_parallel", "floyd_parallel" }, { 1, 8 }, 0, 1);
+    ASSERT_EQ(weak.size(), 2u);
+    EXPECT_EQ(weak[0].points.front().num_vert, 64u);
+    EXPECT_EQ(weak[1].points.front().num_vert, 16u);
+    if (weak[0].points.size() > 1) {
+        const ScalingPoint& last = weak[0].points.back();
+        EXPECT_EQ(last.num_vert, 64u * last.threads);
+        EXPECT_EQ(weak[1].points.back().num_vert, static_cast<size_t>(std::llround(16 * std::cbrt(last.threads))));
+    }
+
+    // johnson reads the CSR too but grows like floyd, in either order
+    for (auto names : { std::vector<std::string>{ "cc_parallel", "johnson" },
+                        std::vector<std::string>{ "johnson", "cc_parallel" } }) {
+        auto mixed = weak_scaling(base, names, { 1 }, 0, 1);
+        ASSERT_EQ(mixed.size(), 2u);
+        for (const ScalingCurve& curve : mixed)
+            EXPECT_EQ(curve.points.front().num_vert, curve.algorithm == "johnson" ? 16u : 64u) << curve.algorithm;
+    }
+}
+
 TEST_F(GraphTest, EdgeOperations) {
     GraphMatrix matrix(5);
     add_edge_matrix(matrix, 0, 1, 5, 0, true);
@@ -151,6 +953,29 @@ TEST_F(GraphTest, EdgeOperations) {
     EXPECT_TRUE(list.adjList[1].size() == 2); // 1->2 and 2->1 (undirected)
 }
 
+TEST_F(GraphTest, FlatMatrixLayout) {
+    GraphMatrix matrix(20);
+
+    // rows are padded to a cache line and every row starts 64-byte aligned
+    EXPECT_EQ(matrix.weight_matrix.stride() % (64 / sizeof(int)), 0u);
+    EXPECT_GE(matrix.weight_matrix.stride(), 20u);
+    for (size_t i = 0; i < matrix.num_vert; ++i)
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(matrix.weight_matrix[i]) % 64, 0u);
+
+    EXPECT_EQ(matrix.weight_matrix[3][3], 0);
+    EXPECT_EQ(matrix.weight_matrix[3][4], INF);
+
+    // copies are deep
+    Matrix copy = matrix.weight_matrix;
+    copy[0][1] = 7;
+    EXPECT_EQ(matrix.weight_matrix[0][1], INF);
+
+    // views address the same storage
+    MatrixView view = copy.view();
+    EXPECT_EQ(view[0][1], 7);
+    EXPECT_EQ(view.block(0, 1, 2, 2)[0][0], 7);
+}
+
 TEST_F(GraphTest, LargeGraphPerformance) {
     // generate a larger graph for performance testing
     GraphMatrix large_matrix = generate_random_graph_matrix(100, 100, 2000, true);